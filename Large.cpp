@@ -1,5 +1,216 @@
 #include "Large.h"
 
+namespace {
+    const std::array<uint64_t, 3> transform_primes = { 998244353, 167772161, 469762049 };
+    const size_t max_transform_length = size_t(1) << 23;
+
+    uint64_t PowMod(uint64_t base, uint64_t exponent, uint64_t mod) noexcept {
+        uint64_t result = 1;
+        base %= mod;
+        while (exponent != 0) {
+            if (exponent & 1) {
+                result = result * base % mod;
+            }
+            base = base * base % mod;
+            exponent >>= 1;
+        }
+        return result;
+    }
+
+    bool UseTransform(size_t lhs, size_t rhs, size_t limit) noexcept {
+        return std::min(lhs, rhs) >= limit && lhs + rhs - 1 <= max_transform_length;
+    }
+
+    size_t TransformLength(size_t count) noexcept {
+        size_t length = 1;
+        while (length < count) {
+            length <<= 1;
+        }
+        return length;
+    }
+
+    void NumberTheoreticTransform(std::vector<uint32_t>& values, uint64_t mod, bool inverse) noexcept {
+        const size_t n = values.size();
+        for(size_t i = 1, j = 0; i < n; ++i) {
+            size_t bit = n >> 1;
+            for(; j & bit; bit >>= 1) {
+                j ^= bit;
+            }
+            j ^= bit;
+            if (i < j) {
+                std::swap(values[i], values[j]);
+            }
+        }
+
+        std::vector<uint32_t> roots;
+        for(size_t length = 2; length <= n; length <<= 1) {
+            uint64_t root = PowMod(3, (mod - 1) / length, mod);
+            if (inverse) {
+                root = PowMod(root, mod - 2, mod);
+            }
+            const size_t half = length / 2;
+            roots.resize(half);
+            roots[0] = 1;
+            for(size_t j = 1; j < half; ++j) {
+                roots[j] = static_cast<uint32_t>(roots[j - 1] * root % mod);
+            }
+            for(size_t i = 0; i < n; i += length) {
+                for(size_t j = 0; j < half; ++j) {
+                    const uint64_t u = values[i + j];
+                    const uint64_t v = values[i + j + half] * static_cast<uint64_t>(roots[j]) % mod;
+                    values[i + j] = static_cast<uint32_t>(u + v < mod ? u + v : u + v - mod);
+                    values[i + j + half] = static_cast<uint32_t>(u >= v ? u - v : u + mod - v);
+                }
+            }
+        }
+        if (inverse) {
+            const uint64_t scale = PowMod(n, mod - 2, mod);
+            for(uint32_t& value : values) {
+                value = static_cast<uint32_t>(value * scale % mod);
+            }
+        }
+    }
+
+    std::vector<bool> ExponentBits(std::vector<uint64_t> digits) noexcept {
+        const uint64_t base = 1e9;
+        std::vector<bool> bits;
+        while (!digits.empty()) {
+            uint64_t remainder = 0;
+            for(int64_t i = static_cast<int64_t>(digits.size()) - 1; i >= 0; --i) {
+                const uint64_t current = remainder * base + digits[i];
+                digits[i] = current >> 32;
+                remainder = current & 0xffffffff;
+            }
+            while (!digits.empty() && digits.back() == 0) {
+                digits.pop_back();
+            }
+            for(size_t bit = 0; bit < 32; ++bit) {
+                bits.push_back((remainder >> bit) & 1);
+            }
+        }
+        while (!bits.empty() && !bits.back()) {
+            bits.pop_back();
+        }
+        return bits;
+    }
+
+    size_t WindowSize(size_t bits) noexcept {
+        if (bits <= 8) {
+            return 1;
+        }
+        if (bits <= 64) {
+            return 3;
+        }
+        return bits <= 512 ? 4 : 5;
+    }
+
+    template<class Square, class Multiply>
+    void SlidingWindow(const std::vector<bool>& bits, size_t window, Square&& square, Multiply&& multiply) {
+        int64_t i = static_cast<int64_t>(bits.size()) - 1;
+        while (i >= 0) {
+            if (!bits[i]) {
+                square();
+                --i;
+                continue;
+            }
+            int64_t j = std::max<int64_t>(i - static_cast<int64_t>(window) + 1, 0);
+            while (!bits[j]) {
+                ++j;
+            }
+            size_t value = 0;
+            for(int64_t k = i; k >= j; --k) {
+                value = value << 1 | bits[k];
+                square();
+            }
+            multiply(value >> 1);
+            i = j - 1;
+        }
+    }
+
+    class Montgomery {
+    public:
+        explicit Montgomery(std::vector<uint64_t> mod) : mod_(std::move(mod)) {
+            int64_t old_r = static_cast<int64_t>(mod_[0]), r = base_, old_s = 1, s = 0;
+            while (r != 0) {
+                const int64_t q = old_r / r;
+                old_r = std::exchange(r, old_r - q * r);
+                old_s = std::exchange(s, old_s - q * s);
+            }
+            const int64_t inverse = (old_s % base_ + base_) % base_;
+            inverse_ = static_cast<uint64_t>((base_ - inverse) % base_);
+        }
+
+        void Multiply(const std::vector<uint64_t>& lhs, const std::vector<uint64_t>& rhs,
+                      std::vector<uint64_t>& result) noexcept {
+            const size_t n = mod_.size();
+            buffer_.assign(2 * n + 1, 0);
+            for(size_t i = 0; i < n; ++i) {
+                uint64_t carry = 0;
+                for(size_t j = 0; j < n; ++j) {
+                    const uint64_t current = buffer_[i + j] + lhs[i] * rhs[j] + carry;
+                    buffer_[i + j] = current % base_;
+                    carry = current / base_;
+                }
+                buffer_[i + n] += carry;
+            }
+            for(size_t i = 0; i < n; ++i) {
+                const uint64_t u = buffer_[i] * inverse_ % base_;
+                uint64_t carry = 0;
+                for(size_t j = 0; j < n; ++j) {
+                    const uint64_t current = buffer_[i + j] + u * mod_[j] + carry;
+                    buffer_[i + j] = current % base_;
+                    carry = current / base_;
+                }
+                for(size_t k = i + n; carry != 0; ++k) {
+                    const uint64_t current = buffer_[k] + carry;
+                    buffer_[k] = current % base_;
+                    carry = current / base_;
+                }
+            }
+
+            bool subtract = buffer_[2 * n] != 0;
+            for(int64_t i = static_cast<int64_t>(n) - 1; i >= 0 && !subtract; --i) {
+                if (buffer_[n + i] != mod_[i]) {
+                    subtract = buffer_[n + i] > mod_[i];
+                    break;
+                }
+                subtract = i == 0;
+            }
+            result.resize(n);
+            uint64_t borrow = 0;
+            for(size_t i = 0; i < n; ++i) {
+                const uint64_t subtrahend = subtract ? mod_[i] + borrow : 0;
+                if (buffer_[n + i] < subtrahend) {
+                    result[i] = buffer_[n + i] + base_ - subtrahend;
+                    borrow = 1;
+                } else {
+                    result[i] = buffer_[n + i] - subtrahend;
+                    borrow = 0;
+                }
+            }
+        }
+
+    private:
+        static const int64_t base_ = 1000000000;
+
+        std::vector<uint64_t> mod_;
+        uint64_t inverse_;
+        std::vector<uint64_t> buffer_;
+    };
+
+    std::array<std::vector<uint32_t>, 3> Transformed(const std::vector<uint64_t>& digits, size_t length) noexcept {
+        std::array<std::vector<uint32_t>, 3> values;
+        for(size_t p = 0; p < transform_primes.size(); ++p) {
+            values[p].assign(length, 0);
+            for(size_t i = 0; i < digits.size(); ++i) {
+                values[p][i] = static_cast<uint32_t>(digits[i] % transform_primes[p]);
+            }
+            NumberTheoreticTransform(values[p], transform_primes[p], false);
+        }
+        return values;
+    }
+}
+
 Large::Large(const std::string& value) noexcept {
     sign_ = Sign::Plus;
 
@@ -31,6 +242,30 @@ Large::Large(const std::string& value) noexcept {
     }
 }
 
+Large::Large(int64_t value) : sign_(value < 0 ? Sign::Minus : Sign::Plus) {
+    uint64_t magnitude = value < 0 ? ~static_cast<uint64_t>(value) + 1 : static_cast<uint64_t>(value);
+    do {
+        digits_.push_back(magnitude % base_);
+        magnitude /= base_;
+    } while (magnitude != 0);
+}
+
+Large::operator int64_t() const noexcept {
+    uint64_t result = 0;
+    for(int64_t i = static_cast<int64_t>(digits_.size()) - 1; i >= 0; --i) {
+        result = result * base_ + digits_[i];
+    }
+    return sign_ == Sign::Minus ? static_cast<int64_t>(~result + 1) : static_cast<int64_t>(result);
+}
+
+Large::operator double() const noexcept {
+    double result = 0;
+    for(int64_t i = static_cast<int64_t>(digits_.size()) - 1; i >= 0; --i) {
+        result = result * static_cast<double>(base_) + static_cast<double>(digits_[i]);
+    }
+    return sign_ == Sign::Minus ? -result : result;
+}
+
 bool Large::operator<(const Large& other) const noexcept {
     if (*this == other) {
         return false;
@@ -124,6 +359,26 @@ Large Large::SimpleMult(const Large& lhs, const Large& rhs) const noexcept {
     return result;
 }
 
+size_t Large::Hash() const noexcept {
+    if (IsZero()) {
+        return 0;
+    }
+    uint64_t hash = sign_ == Sign::Minus ? 0xcbf29ce484222325 : 0x84222325cbf29ce4;
+    for(const uint64_t digit : digits_) {
+        hash = (hash ^ digit) * 0x9e3779b97f4a7c15;
+        hash ^= hash >> 32;
+    }
+    return static_cast<size_t>(hash);
+}
+
+uint64_t Large::Residue(uint64_t mod) const noexcept {
+    uint64_t result = 0;
+    for(int64_t i = static_cast<int64_t>(digits_.size()) - 1; i >= 0; --i) {
+        result = static_cast<uint64_t>((static_cast<unsigned __int128>(result) * base_ + digits_[i]) % mod);
+    }
+    return sign_ == Sign::Minus && result != 0 ? mod - result : result;
+}
+
 Large Large::MultByBase(int64_t power) const noexcept {
     Large other = *this;
     std::reverse(other.digits_.begin(), other.digits_.end());
@@ -144,10 +399,96 @@ Large Large::MultByBase(int64_t power) const noexcept {
     return other;
 }
 
+Large::Transform::Transform(const Large& value, size_t other_size) noexcept :
+    value_(value), length_(TransformLength(value.Size() + std::max<size_t>(other_size, 1) - 1)),
+    values_(Transformed(value.digits_, length_)) {}
+
+Large Large::FromConvolution(std::array<std::vector<uint32_t>, 3>& values, size_t count, bool negative) noexcept {
+    for(size_t p = 0; p < transform_primes.size(); ++p) {
+        NumberTheoreticTransform(values[p], transform_primes[p], true);
+    }
+    const uint64_t p0 = transform_primes[0], p1 = transform_primes[1], p2 = transform_primes[2];
+    const uint64_t inv_p0 = PowMod(p0, p1 - 2, p1);
+    const uint64_t inv_p0p1 = PowMod(p0 % p2 * (p1 % p2) % p2, p2 - 2, p2);
+
+    Large result;
+    result.digits_.clear();
+    unsigned __int128 carry = 0;
+    for(size_t i = 0; i < count; ++i) {
+        const uint64_t x0 = values[0][i];
+        const uint64_t x1 = (values[1][i] + p1 - x0 % p1) % p1 * inv_p0 % p1;
+        const uint64_t x2 = (values[2][i] + p2 - (x0 + x1 * p0) % p2) % p2 * inv_p0p1 % p2;
+        carry += x0 + static_cast<unsigned __int128>(x1) * p0 + static_cast<unsigned __int128>(x2) * p0 * p1;
+        result.digits_.push_back(static_cast<uint64_t>(carry % result.base_));
+        carry /= result.base_;
+    }
+    while (carry != 0) {
+        result.digits_.push_back(static_cast<uint64_t>(carry % result.base_));
+        carry /= result.base_;
+    }
+    while (result.digits_.size() > 1 && result.digits_.back() == 0) {
+        result.digits_.pop_back();
+    }
+    result.sign_ = negative && !result.IsZero() ? Sign::Minus : Sign::Plus;
+    return result;
+}
+
+Large Large::operator*(const Transform& other) const noexcept {
+    if (IsZero() || other.value_.IsZero()) {
+        return 0;
+    }
+    const size_t count = digits_.size() + other.Size() - 1;
+    if (count > other.length_) {
+        return *this * other.value_;
+    }
+    std::array<std::vector<uint32_t>, 3> values = Transformed(digits_, other.length_);
+    for(size_t p = 0; p < transform_primes.size(); ++p) {
+        for(size_t i = 0; i < other.length_; ++i) {
+            values[p][i] = static_cast<uint32_t>(static_cast<uint64_t>(values[p][i]) * other.values_[p][i] %
+                                                 transform_primes[p]);
+        }
+    }
+    return FromConvolution(values, count, sign_ != other.value_.sign_);
+}
+
+Large Large::Squared() const noexcept {
+    if (IsZero()) {
+        return 0;
+    }
+    if (digits_.size() == 1) {
+        return SimpleMult(*this, *this);
+    }
+    if (digits_.size() < transform_limit_) {
+        Large result;
+        std::vector<uint64_t> buffer;
+        MultSubtract(*this, *this, Large(), Large(), result, buffer);
+        return result;
+    }
+    if (UseTransform(digits_.size(), digits_.size(), transform_limit_)) {
+        const size_t count = 2 * digits_.size() - 1;
+        std::array<std::vector<uint32_t>, 3> values = Transformed(digits_, TransformLength(count));
+        for(size_t p = 0; p < transform_primes.size(); ++p) {
+            for(uint32_t& value : values[p]) {
+                value = static_cast<uint32_t>(static_cast<uint64_t>(value) * value % transform_primes[p]);
+            }
+        }
+        return FromConvolution(values, count, false);
+    }
+    int64_t n = static_cast<int64_t>(digits_.size() / 2);
+    Large a = abs(*this).MultByBase(-n);
+    Large b = abs(*this) - a.MultByBase(n);
+    Large high = a.Squared(), low = b.Squared();
+
+    return high.MultByBase(2 * n) + ((a + b).Squared() - high - low).MultByBase(n) + low;
+}
+
 Large Large::operator*(const Large& other) const noexcept {
     if (IsZero() || other.IsZero()) {
         return 0;
     }
+    if (this == &other) {
+        return Squared();
+    }
     if (sign_ != other.sign_) {
         return -(abs(*this) * abs(other));
     }
@@ -160,6 +501,15 @@ Large Large::operator*(const Large& other) const noexcept {
     if (other.digits_.size() == 1) {
         return SimpleMult(*this, other);
     }
+    if (std::min(digits_.size(), other.digits_.size()) < transform_limit_) {
+        Large result;
+        std::vector<uint64_t> buffer;
+        MultSubtract(*this, other, Large(), Large(), result, buffer);
+        return result;
+    }
+    if (UseTransform(digits_.size(), other.digits_.size(), transform_limit_)) {
+        return *this * Transform(other, digits_.size());
+    }
     int64_t n = static_cast<int64_t>(std::max(digits_.size(), other.digits_.size()) / 2);
     Large a = this->MultByBase(-n);
     Large b = *this - a.MultByBase(n);
@@ -169,6 +519,97 @@ Large Large::operator*(const Large& other) const noexcept {
     return (a * c).MultByBase(2 * n) + ((a + b) * (c + d) -  a * c - b * d).MultByBase(n) + b * d;
 }
 
+void Large::MultSubtract(const Large& x, const Large& a, const Large& y, const Large& b, Large& result,
+                         std::vector<uint64_t>& buffer) noexcept {
+    const int64_t base = 1e9;
+    const int first = x.IsZero() || a.IsZero() ? 0 : (x.sign_ == a.sign_ ? 1 : -1);
+    const int second = y.IsZero() || b.IsZero() ? 0 : (y.sign_ == b.sign_ ? -1 : 1);
+    if (first == 0 && second == 0) {
+        result = 0;
+        return;
+    }
+    const size_t length = std::max(first != 0 ? x.Size() + a.Size() : 0, second != 0 ? y.Size() + b.Size() : 0);
+    buffer.resize(length);
+
+    __int128 carry = 0;
+    for(size_t k = 0; k < length; ++k) {
+        unsigned __int128 positive = 0, negative = 0;
+        if (first != 0) {
+            unsigned __int128& sum = first > 0 ? positive : negative;
+            const size_t begin = k + 1 > a.Size() ? k + 1 - a.Size() : 0;
+            for(size_t i = begin; i <= k && i < x.Size(); ++i) {
+                sum += x.digits_[i] * a.digits_[k - i];
+            }
+        }
+        if (second != 0) {
+            unsigned __int128& sum = second > 0 ? positive : negative;
+            const size_t begin = k + 1 > b.Size() ? k + 1 - b.Size() : 0;
+            for(size_t i = begin; i <= k && i < y.Size(); ++i) {
+                sum += y.digits_[i] * b.digits_[k - i];
+            }
+        }
+        __int128 value = carry + static_cast<__int128>(positive) - static_cast<__int128>(negative);
+        carry = value / base;
+        value %= base;
+        if (value < 0) {
+            value += base;
+            --carry;
+        }
+        buffer[k] = static_cast<uint64_t>(value);
+    }
+    while (carry != 0 && carry != -1) {
+        __int128 value = carry % base;
+        carry /= base;
+        if (value < 0) {
+            value += base;
+            --carry;
+        }
+        buffer.push_back(static_cast<uint64_t>(value));
+    }
+
+    result.sign_ = Sign::Plus;
+    if (carry == -1) {
+        result.sign_ = Sign::Minus;
+        uint64_t borrow = 0;
+        for(uint64_t& digit : buffer) {
+            const uint64_t subtrahend = digit + borrow;
+            digit = subtrahend == 0 ? 0 : base - subtrahend;
+            borrow = subtrahend == 0 ? 0 : 1;
+        }
+    }
+    while (buffer.size() > 1 && buffer.back() == 0) {
+        buffer.pop_back();
+    }
+    if (buffer.size() == 1 && buffer[0] == 0) {
+        result.sign_ = Sign::Plus;
+    }
+    result.digits_.swap(buffer);
+}
+
+void Large::ScaleSubtract(std::vector<Large>& row, const std::vector<Large>& other,
+                          const Large& lhs, const Large& rhs, std::vector<Transform>* transforms) noexcept {
+    const Large a = lhs, b = rhs;
+    std::vector<uint64_t> buffer;
+    for(size_t col = 0; col < row.size(); ++col) {
+        Large& elem = row[col];
+        const Large& sub = other[col];
+        if (transforms != nullptr && !b.IsZero() && UseTransform(sub.Size(), b.Size(), transform_limit_)) {
+            if (transforms->size() != row.size()) {
+                transforms->assign(row.size(), Transform());
+            }
+            Transform& transform = (*transforms)[col];
+            if (transform.Size() != sub.Size() || transform.Length() < sub.Size() + b.Size() - 1) {
+                transform = Transform(sub, std::max(sub.Size(), b.Size()));
+            }
+            elem = elem * a - b * transform;
+        } else if (std::max(elem.Size(), sub.Size()) > fused_limit_ || std::max(a.Size(), b.Size()) > fused_limit_) {
+            elem = elem * a - sub * b;
+        } else {
+            MultSubtract(elem, a, sub, b, elem, buffer);
+        }
+    }
+}
+
 Large Large::operator/(const Large& other) const {
     if (other.IsZero()) {
         throw std::logic_error("Division by zero");
@@ -183,8 +624,8 @@ Large Large::operator/(const Large& other) const {
         return 0;
     }
     Large result;
-    result.digits_ = std::vector<uint64_t>(digits_.size(), 0);
-    for(int64_t i = static_cast<int64_t>(digits_.size()) - 1; i >= 0; --i) {
+    result.digits_ = std::vector<uint64_t>(digits_.size() - other.digits_.size() + 1, 0);
+    for(int64_t i = static_cast<int64_t>(result.digits_.size()) - 1; i >= 0; --i) {
         uint64_t L = 0, R = base_, M;
         while (L < R - 1) {
             M = L + (R - L) / 2;
@@ -231,17 +672,115 @@ Large pow(const Large& num, const Large& n) {
     if (n < 0) {
         throw std::logic_error("Power must be positive");
     }
-    if (num.IsZero() || num.digits_.size() == 1 && num.digits_[0] == 1) {
+    if (num.IsZero() || num == 1) {
         return num;
     }
     if (n == 0) {
         return 1;
     }
-    if (n.digits_[0] % 2 == 1) {
-        return num * pow(num, n - 1);
+
+    std::vector<uint64_t> buffer;
+    const Large zero;
+    auto multiply = [&](Large& value, const Large& other) {
+        if (std::min(value.Size(), other.Size()) < Large::transform_limit_) {
+            Large::MultSubtract(value, other, zero, zero, value, buffer);
+        } else {
+            value = &value == &other ? value.Squared() : value * other;
+        }
+    };
+
+    const std::vector<bool> bits = ExponentBits(n.digits_);
+    const size_t window = WindowSize(bits.size());
+    std::vector<Large> powers(size_t(1) << (window - 1), num);
+    if (powers.size() > 1) {
+        Large square = num;
+        multiply(square, square);
+        for(size_t i = 1; i < powers.size(); ++i) {
+            powers[i] = powers[i - 1];
+            multiply(powers[i], square);
+        }
     }
-    Large tmp = pow(num, n / 2);
-    return tmp * tmp;
+
+    Large result = 1;
+    SlidingWindow(bits, window, [&]() {
+        multiply(result, result);
+    }, [&](size_t index) {
+        multiply(result, powers[index]);
+    });
+    return result;
+}
+
+Large powmod(const Large& num, const Large& n, const Large& mod) {
+    if (n < 0) {
+        throw std::logic_error("Power must be positive");
+    }
+    if (mod <= 0) {
+        throw std::logic_error("Modulus must be positive");
+    }
+    Large reduced = num % mod;
+    if (reduced < 0) {
+        reduced += mod;
+    }
+    if (mod == 1) {
+        return 0;
+    }
+    if (n == 0) {
+        return 1;
+    }
+    if (reduced.IsZero()) {
+        return 0;
+    }
+
+    const std::vector<bool> bits = ExponentBits(n.digits_);
+    const size_t window = WindowSize(bits.size());
+    if (mod.digits_[0] % 2 == 0 || mod.digits_[0] % 5 == 0) {
+        std::vector<Large> powers(size_t(1) << (window - 1), reduced);
+        const Large square = reduced * reduced % mod;
+        for(size_t i = 1; i < powers.size(); ++i) {
+            powers[i] = powers[i - 1] * square % mod;
+        }
+        Large result = 1;
+        SlidingWindow(bits, window, [&]() {
+            result = result.Squared() % mod;
+        }, [&](size_t index) {
+            result = result * powers[index] % mod;
+        });
+        return result;
+    }
+
+    const size_t size = mod.digits_.size();
+    Montgomery montgomery(mod.digits_);
+    auto to_montgomery = [&](const Large& value) {
+        std::vector<uint64_t> digits = (value.MultByBase(static_cast<int64_t>(size)) % mod).digits_;
+        digits.resize(size, 0);
+        return digits;
+    };
+
+    std::vector<std::vector<uint64_t>> powers(size_t(1) << (window - 1), to_montgomery(reduced));
+    if (powers.size() > 1) {
+        std::vector<uint64_t> square;
+        montgomery.Multiply(powers[0], powers[0], square);
+        for(size_t i = 1; i < powers.size(); ++i) {
+            montgomery.Multiply(powers[i - 1], square, powers[i]);
+        }
+    }
+
+    std::vector<uint64_t> result = to_montgomery(1);
+    SlidingWindow(bits, window, [&]() {
+        montgomery.Multiply(result, result, result);
+    }, [&](size_t index) {
+        montgomery.Multiply(result, powers[index], result);
+    });
+
+    std::vector<uint64_t> one(size, 0);
+    one[0] = 1;
+    montgomery.Multiply(result, one, result);
+    while (result.size() > 1 && result.back() == 0) {
+        result.pop_back();
+    }
+    Large value;
+    value.digits_ = std::move(result);
+    return value;
 }
 
 std::istream& operator>>(std::istream& is, Large& num) noexcept {
@@ -2,20 +2,22 @@
 
 #include <string>
 #include <vector>
+#include <array>
 #include <algorithm>
 #include <cstdint>
 #include <utility>
 #include <stdexcept>
+#include <functional>
 
 class Large {
 public:
+    class Transform;
+
     Large() : digits_({ 0 }), sign_(Sign::Plus) {}
 
     Large(const std::string& value) noexcept;
 
-    Large(int64_t value) {
-        *this = Large(std::to_string(value));
-    }
+    Large(int64_t value);
 
     Large(const Large& other) : digits_(other.digits_), sign_(other.sign_) {}
 
@@ -24,6 +26,25 @@ public:
 
     ~Large() = default;
 
+    [[nodiscard]] size_t Size() const noexcept {
+        return digits_.size();
+    }
+
+    explicit operator int64_t() const noexcept;
+
+    explicit operator double() const noexcept;
+
+    [[nodiscard]] Large MultByBase(int64_t power) const noexcept;
+
+    [[nodiscard]] size_t Hash() const noexcept;
+
+    [[nodiscard]] uint64_t Residue(uint64_t mod) const noexcept;
+
+    [[nodiscard]] Large Squared() const noexcept;
+
+    static void ScaleSubtract(std::vector<Large>& row, const std::vector<Large>& other,
+                              const Large& lhs, const Large& rhs, std::vector<Transform>* transforms = nullptr) noexcept;
+
     bool operator==(const Large& other) const noexcept {
         if (IsZero() && other.IsZero()) {
             return true;
@@ -95,6 +116,8 @@ public:
 
     Large operator*(const Large& other) const noexcept;
 
+    Large operator*(const Transform& other) const noexcept;
+
     Large operator/(const Large& other) const;
 
     Large operator%(const Large& other) const;
@@ -125,6 +148,8 @@ public:
 
     friend Large pow(const Large& num, const Large& n);
 
+    friend Large powmod(const Large& num, const Large& n, const Large& mod);
+
     friend std::istream& operator>>(std::istream& is, Large& num) noexcept;
 
     friend std::ostream& operator<<(std::ostream& os, const Large& num) noexcept;
@@ -135,6 +160,8 @@ private:
     Sign sign_;
     std::vector<uint64_t> digits_;
     const uint64_t base_ = 1e9;
+    static const size_t fused_limit_ = 1024;
+    static const size_t transform_limit_ = 256;
 
     bool IsZero() const noexcept {
         return digits_.size() == 1 && digits_[0] == 0;
@@ -149,5 +176,41 @@ private:
 
     Large SimpleMult(const Large& lhs, const Large& rhs) const noexcept;
 
-    Large MultByBase(int64_t power) const noexcept;
+    static void MultSubtract(const Large& x, const Large& a, const Large& y, const Large& b, Large& result,
+                             std::vector<uint64_t>& buffer) noexcept;
+
+    static Large FromConvolution(std::array<std::vector<uint32_t>, 3>& values, size_t count, bool negative) noexcept;
+};
+
+class Large::Transform {
+public:
+    Transform() = default;
+
+    Transform(const Large& value, size_t other_size) noexcept;
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return value_.Size();
+    }
+
+    [[nodiscard]] size_t Length() const noexcept {
+        return length_;
+    }
+
+    [[nodiscard]] const Large& Value() const noexcept {
+        return value_;
+    }
+
+private:
+    friend class Large;
+
+    Large value_;
+    size_t length_ = 0;
+    std::array<std::vector<uint32_t>, 3> values_;
+};
+
+template<>
+struct std::hash<Large> {
+    size_t operator()(const Large& num) const noexcept {
+        return num.Hash();
+    }
 };
@@ -1,4 +1,218 @@
 #include "LinearEquationSystem.h"
+#include "Rational.h"
+#include <cmath>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace {
+    double Log2(const Large& value) noexcept {
+        if (value.Size() > 30) {
+            const int64_t shift = static_cast<int64_t>(value.Size()) - 30;
+            return Log2(value.MultByBase(-shift)) + static_cast<double>(shift) * std::log2(1e9);
+        }
+        return std::log2(std::abs(static_cast<double>(value)));
+    }
+
+    Large RoundToLarge(double value) {
+        if (std::abs(value) < 0x1p62) {
+            return std::llround(value);
+        }
+        int exponent;
+        double mantissa = std::frexp(value, &exponent);
+        return Large(static_cast<int64_t>(std::ldexp(mantissa, 53))) * pow(Large(2), exponent - 53);
+    }
+
+    Large Quotient(const Large& a, const Large& b) {
+        if (a < b) {
+            return 0;
+        }
+        if (a.Size() > b.Size() + 1) {
+            return a / b;
+        }
+        const int64_t shift = b.Size() > 3 ? static_cast<int64_t>(b.Size()) - 3 : 0;
+        const double estimate = static_cast<double>(a.MultByBase(-shift)) / static_cast<double>(b.MultByBase(-shift));
+        if (estimate > 0x1p40) {
+            return a / b;
+        }
+        Large quotient = static_cast<int64_t>(estimate);
+        Large remainder = a - quotient * b;
+        while (remainder < 0) {
+            --quotient;
+            remainder += b;
+        }
+        while (remainder >= b) {
+            ++quotient;
+            remainder -= b;
+        }
+        return quotient;
+    }
+
+    void Reconstruct(const Large& numerator, const Large& denominator, Large& p, Large& q) {
+        Large a = abs(numerator), b = denominator;
+        Large p_prev = 0, q_prev = 1;
+        p = 1, q = 0;
+        while (b != 0) {
+            Large quotient = Quotient(a, b);
+            Large q_next = quotient * q + q_prev;
+            if (q_next * q_next * 2 > denominator) {
+                break;
+            }
+            Large p_next = quotient * p + p_prev;
+            p_prev = std::exchange(p, std::move(p_next));
+            q_prev = std::exchange(q, std::move(q_next));
+            a = std::exchange(b, a - quotient * b);
+        }
+        if (q == 0) {
+            p = 0, q = 1;
+        } else if (numerator < 0) {
+            p = -p;
+        }
+    }
+
+    size_t ModularRank(std::vector<std::vector<uint64_t>> rows) noexcept {
+        const uint64_t mod = (uint64_t(1) << 61) - 1;
+        auto mult = [&](uint64_t a, uint64_t b) {
+            return static_cast<uint64_t>(static_cast<unsigned __int128>(a) * b % mod);
+        };
+        size_t rank = 0;
+        for(size_t col = 0; !rows.empty() && col < rows[0].size() && rank < rows.size(); ++col) {
+            size_t pivot = rank;
+            while (pivot < rows.size() && rows[pivot][col] == 0) {
+                ++pivot;
+            }
+            if (pivot == rows.size()) {
+                continue;
+            }
+            std::swap(rows[rank], rows[pivot]);
+            const uint64_t inverse = [&]() {
+                uint64_t result = 1, base = rows[rank][col], exponent = mod - 2;
+                for(; exponent != 0; exponent >>= 1, base = mult(base, base)) {
+                    if (exponent & 1) {
+                        result = mult(result, base);
+                    }
+                }
+                return result;
+            }();
+            for(size_t row = rank + 1; row < rows.size(); ++row) {
+                if (rows[row][col] == 0) {
+                    continue;
+                }
+                const uint64_t factor = mult(rows[row][col], inverse);
+                for(size_t j = col; j < rows[row].size(); ++j) {
+                    rows[row][j] = (rows[row][j] + mod - mult(factor, rows[rank][j])) % mod;
+                }
+            }
+            ++rank;
+        }
+        return rank;
+    }
+
+    template<class Key, class Value, class Hash = std::hash<Key>>
+    class LRUCache {
+    public:
+        explicit LRUCache(size_t capacity = 0) : capacity_(capacity) {}
+
+        [[nodiscard]] size_t Size() const noexcept {
+            return entries_.size();
+        }
+
+        [[nodiscard]] size_t Capacity() const noexcept {
+            return capacity_;
+        }
+
+        const Value* Find(const Key& key) {
+            auto it = entries_.find(key);
+            if (it == entries_.end()) {
+                return nullptr;
+            }
+            order_.splice(order_.begin(), order_, it->second.position);
+            return &it->second.value;
+        }
+
+        void Insert(Key key, Value value) {
+            if (capacity_ == 0) {
+                return;
+            }
+            auto it = entries_.find(key);
+            if (it != entries_.end()) {
+                it->second.value = std::move(value);
+                order_.splice(order_.begin(), order_, it->second.position);
+                return;
+            }
+            if (entries_.size() == capacity_) {
+                entries_.erase(*order_.back());
+                order_.pop_back();
+            }
+            it = entries_.emplace(std::move(key), Entry{ std::move(value), {} }).first;
+            order_.push_front(&it->first);
+            it->second.position = order_.begin();
+        }
+
+    private:
+        struct Entry {
+            Value value;
+            typename std::list<const Key*>::iterator position;
+        };
+
+        size_t capacity_;
+        std::list<const Key*> order_;
+        std::unordered_map<Key, Entry, Hash> entries_;
+    };
+
+    struct SolveKey {
+        LinearEquationSystem::PivotStrategy strategy;
+        size_t vars;
+        Matrix<Large> matrix;
+
+        bool operator==(const SolveKey& other) const noexcept {
+            return strategy == other.strategy && vars == other.vars && matrix == other.matrix;
+        }
+    };
+
+    struct SolveKeyHash {
+        size_t operator()(const SolveKey& key) const noexcept {
+            return key.matrix.Hash() ^ (key.vars * 0x9e3779b97f4a7c15 + static_cast<size_t>(key.strategy));
+        }
+    };
+
+    struct SolveResult {
+        std::vector<std::vector<Large>> data;
+        std::vector<size_t> pivots;
+    };
+
+    struct SolveCache {
+        std::mutex mutex;
+        LRUCache<SolveKey, SolveResult, SolveKeyHash> entries;
+        size_t hits = 0, misses = 0;
+    };
+
+    SolveCache& GetSolveCache() {
+        static SolveCache cache;
+        return cache;
+    }
+
+    std::optional<SolveKey> MakeSolveKey(LinearEquationSystem::PivotStrategy strategy, size_t vars,
+                                         const std::vector<std::vector<Large>>& data) {
+        SolveCache& cache = GetSolveCache();
+        {
+            std::lock_guard lock(cache.mutex);
+            if (cache.entries.Capacity() == 0) {
+                return std::nullopt;
+            }
+        }
+        std::vector<std::vector<Large>> rows = data;
+        // First and SmallestSize always pivot on the leading column and end in the same reduced form
+        // for any row order, Markowitz and Full may choose other pivot columns depending on the order
+        if (strategy == LinearEquationSystem::PivotStrategy::First ||
+            strategy == LinearEquationSystem::PivotStrategy::SmallestSize) {
+            std::sort(rows.begin(), rows.end());
+        }
+        return SolveKey{ strategy, vars, Matrix<Large>(rows) };
+    }
+}
 
 std::ostream& operator<<(std::ostream& out, const LinearEquationSystem& matrix) {
     int32_t need_width = 0;
@@ -9,7 +223,7 @@ std::ostream& operator<<(std::ostream& out, const LinearEquationSystem& matrix)
     }
     for (size_t i = 0; i < matrix.data_.size(); ++i) {
         for (size_t j = 0; j < matrix.data_[i].size(); ++j) {
-            if (j + 1 == matrix.data_[i].size()) {
+            if (j == matrix.vars_) {
                 out << std::setw(need_width) << "| ";
             }
             out << std::setw(need_width) << matrix.data_[i][j];
@@ -25,23 +239,70 @@ std::ostream& operator<<(std::ostream& out, const LinearEquationSystem& matrix)
 }
 
 [[maybe_unused]] Matrix<Large> LinearEquationSystem::GetRatio() const noexcept {
-    Matrix<Large> mat(rows(), columns() - 1);
+    Matrix<Large> mat(rows(), vars_);
     return mat.ForEach([&](size_t i, size_t j, Large& elem) {
         elem = data_[i][j];
     });
 }
 
 [[maybe_unused]] Matrix<Large> LinearEquationSystem::GetColumn() const noexcept {
-    Matrix<Large> mat(rows(), 1);
+    Matrix<Large> mat(rows(), cols_ - vars_);
     return mat.ForEach([&](size_t i, size_t j, Large& elem) {
-        elem = data_[i][cols_ - 1];
+        elem = data_[i][vars_ + j];
     });
 }
 
 void LinearEquationSystem::SwapRows(size_t i, size_t j) noexcept {
-    ForRow(i, [&](size_t col, Large& elem) {
-        std::swap(elem, data_[j][col]);
-    });
+    if (i == j) {
+        return;
+    }
+    std::swap(data_[i], data_[j]);
+    history_.emplace_back(RowOperation::Swap, i, j);
+}
+
+void LinearEquationSystem::MoveRow(size_t from, size_t to) noexcept {
+    if (from == to) {
+        return;
+    }
+    if (from < to) {
+        std::rotate(data_.begin() + from, data_.begin() + from + 1, data_.begin() + to + 1);
+    } else {
+        std::rotate(data_.begin() + to, data_.begin() + from, data_.begin() + from + 1);
+    }
+    history_.emplace_back(RowOperation::Move, from, to);
+}
+
+void LinearEquationSystem::CombineRows(size_t row, size_t other, const Large& lhs, const Large& rhs,
+                                       std::vector<Large::Transform>* transforms) noexcept {
+    Large::ScaleSubtract(data_[row], data_[other], lhs, rhs, transforms);
+    history_.emplace_back(RowOperation::Combine, row, other, lhs, rhs);
+}
+
+void LinearEquationSystem::EliminateColumn(size_t row, size_t pivot_row, size_t column,
+                                           std::vector<Large::Transform>* transforms) noexcept {
+    if (data_[row][column] == 0) {
+        return;
+    }
+    Large gcd_ = gcd(data_[pivot_row][column], data_[row][column]);
+    CombineRows(row, pivot_row, data_[pivot_row][column] / gcd_, data_[row][column] / gcd_, transforms);
+    SimplifyRow(row);
+}
+
+size_t LinearEquationSystem::LeadingColumn(size_t row) const noexcept {
+    size_t col = 0;
+    while (col < vars_ && data_[row][col] == 0) {
+        ++col;
+    }
+    return col;
+}
+
+bool LinearEquationSystem::IsZeroRow(size_t row) const noexcept {
+    for(size_t col = 0; col < cols_; ++col) {
+        if (data_[row][col] != 0) {
+            return false;
+        }
+    }
+    return true;
 }
 
 void LinearEquationSystem::SimplifyRow(size_t row) noexcept {
@@ -67,94 +328,785 @@ void LinearEquationSystem::SimplifyRow(size_t row) noexcept {
                 elem /= gcd_;
             }
         });
+        history_.emplace_back(RowOperation::Divide, row, row, gcd_);
     }
 }
 
-void LinearEquationSystem::MakeStepwise() noexcept {
-    size_t upper_row = 0;
-    for(size_t column = 0; column + 1 < cols_; ++column) {
-        int32_t row_num = -1;
+size_t LinearEquationSystem::CountNonZeros(size_t row, const std::vector<bool>& used) const noexcept {
+    size_t count = 0;
+    for(size_t col = 0; col < vars_; ++col) {
+        if (!used[col] && data_[row][col] != 0) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool LinearEquationSystem::SelectPivot(PivotStrategy strategy, size_t upper_row, size_t& pivot_row,
+                                       size_t& pivot_column) const noexcept {
+    std::vector<bool> used(vars_, false);
+    for(size_t row = 0; row < upper_row; ++row) {
+        used[pivots_[row]] = true;
+    }
+    // Markowitz and Full search the whole remaining submatrix, so their pivot columns may differ
+    const bool whole = strategy == PivotStrategy::Markowitz || strategy == PivotStrategy::Full;
+    size_t column = pivot_column;
+    if (!whole) {
+        while (column < vars_) {
+            bool found = false;
+            for(size_t row = upper_row; row < rows_ && !found; ++row) {
+                found = data_[row][column] != 0;
+            }
+            if (found) {
+                break;
+            }
+            ++column;
+        }
+        if (column == vars_) {
+            return false;
+        }
+    }
+
+    std::vector<size_t> column_count(vars_, 0);
+    if (strategy == PivotStrategy::Markowitz) {
         for(size_t row = upper_row; row < rows_; ++row) {
-            if (data_[row][column] != 0) {
-                row_num = static_cast<int32_t>(row);
+            for(size_t col = 0; col < vars_; ++col) {
+                column_count[col] += !used[col] && data_[row][col] != 0;
+            }
+        }
+    }
+
+    bool found = false;
+    size_t best_size = 0, best_cost = 0;
+    for(size_t row = upper_row; row < rows_; ++row) {
+        const size_t count = strategy == PivotStrategy::Markowitz ? CountNonZeros(row, used) : 0;
+        for(size_t col = whole ? 0 : column; col < vars_; ++col) {
+            if (used[col] || data_[row][col] == 0) {
+                if (!whole) {
+                    break;
+                }
+                continue;
+            }
+            // (r_i - 1)(c_j - 1) bounds the fill-in, each updated element costs about the pivot's size
+            const size_t size = data_[row][col].Size();
+            const size_t cost = strategy == PivotStrategy::Markowitz ? (count - 1) * (column_count[col] - 1) * size : 0;
+            if (!found || cost < best_cost || (cost == best_cost && size < best_size)) {
+                found = true;
+                best_size = size, best_cost = cost;
+                pivot_row = row, pivot_column = col;
+            }
+            if (!whole) {
                 break;
             }
         }
-        if (row_num == -1) {
-            continue;
+        if (found && strategy == PivotStrategy::First) {
+            break;
+        }
+    }
+    return found;
+}
+
+void LinearEquationSystem::MakeStepwise(PivotStrategy strategy) noexcept {
+    pivots_.clear();
+    size_t pivot_row = 0, pivot_column = 0;
+    for(size_t upper_row = 0; upper_row < rows_; ++upper_row) {
+        if (!SelectPivot(strategy, upper_row, pivot_row, pivot_column)) {
+            break;
         }
-        SwapRows(upper_row, row_num);
+        SwapRows(upper_row, pivot_row);
+        pivots_.push_back(pivot_column);
+        std::vector<Large::Transform> transforms;
         for(size_t row = upper_row + 1; row < rows_; ++row)  {
-            Large gcd_ = gcd(data_[upper_row][column], data_[row][column]);
-            Large leading = data_[row][column];
-            ForRow(row, [&](size_t j, Large& elem) {
-                elem = elem * data_[upper_row][column] / gcd_ - data_[upper_row][j] * leading / gcd_;
-            });
-            SimplifyRow(row);
+            EliminateColumn(row, upper_row, pivot_column, &transforms);
+        }
+        if (strategy != PivotStrategy::Full) {
+            ++pivot_column;
         }
-        ++upper_row;
     }
 }
 
 void LinearEquationSystem::MakeBetterStepwise() noexcept {
-    std::vector<size_t> non_zeros;
+    if (pivots_.empty()) {
+        return;
+    }
+
+    for(size_t row = pivots_.size() - 1; row > 0; --row) {
+        std::vector<Large::Transform> transforms;
+        for(size_t other = 0; other < row; ++other) {
+            EliminateColumn(other, row, pivots_[row], &transforms);
+        }
+    }
+
+    for(size_t row = 1; row < pivots_.size(); ++row) {
+        size_t position = row;
+        while (position > 0 && pivots_[position - 1] > pivots_[row]) {
+            --position;
+        }
+        if (position != row) {
+            MoveRow(row, position);
+            std::rotate(pivots_.begin() + position, pivots_.begin() + row, pivots_.begin() + row + 1);
+        }
+    }
+}
+
+bool LinearEquationSystem::Presolve() noexcept {
+    const bool single = cols_ == vars_ + 1;
+    std::unordered_map<size_t, std::vector<size_t>> directions;
+    std::vector<Large> scale(rows_, 1);
+    std::vector<size_t> core;
     for(size_t row = 0; row < rows_; ++row) {
-        for(size_t col = 0; col + 1 < cols_; ++col) {
+        if (LeadingColumn(row) == vars_) {
+            if (single && !IsZeroRow(row)) {
+                return false;
+            }
+            continue;
+        }
+
+        Large gcd_ = 0;
+        for(size_t col = 0; col < vars_ && gcd_ != 1; ++col) {
             if (data_[row][col] != 0) {
-                non_zeros.push_back(col);
-                break;
+                gcd_ = gcd(gcd_, abs(data_[row][col]));
+            }
+        }
+        size_t hash = vars_;
+        for(size_t col = 0; col < vars_; ++col) {
+            const size_t elem = gcd_ == 1 ? data_[row][col].Hash() : (data_[row][col] / gcd_).Hash();
+            hash ^= elem + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+        }
+        scale[row] = gcd_;
+
+        std::vector<size_t>& bucket = directions[hash];
+        auto same = std::find_if(bucket.begin(), bucket.end(), [&](size_t other) {
+            for(size_t col = 0; col < vars_; ++col) {
+                if (data_[row][col] * scale[other] != data_[other][col] * scale[row]) {
+                    return false;
+                }
             }
+            return true;
+        });
+        if (same == bucket.end()) {
+            bucket.push_back(row);
+            core.push_back(row);
+            continue;
         }
+        CombineRows(row, *same, scale[*same], scale[row]);
+        SimplifyRow(row);
+        if (single && !IsZeroRow(row)) {
+            return false;
+        }
+    }
+    if (!single) {
+        return true;
     }
-    if (non_zeros.empty()) {
+
+    size_t columns = 0;
+    for(size_t col = 0; col < vars_; ++col) {
+        columns += std::any_of(core.begin(), core.end(), [&](size_t row) {
+            return data_[row][col] != 0;
+        });
+    }
+    if (core.size() <= columns) {
+        return true;
+    }
+    // rank(A) <= columns, so a larger rank of [A|b] modulo a prime proves inconsistency
+    const uint64_t mod = (uint64_t(1) << 61) - 1;
+    std::vector<std::vector<uint64_t>> probe(std::min(core.size(), columns + 1 + probe_rows_));
+    for(size_t i = 0; i < probe.size(); ++i) {
+        for(const Large& elem : data_[core[i]]) {
+            probe[i].push_back(elem.Residue(mod));
+        }
+    }
+    return ModularRank(std::move(probe)) <= columns;
+}
+
+std::vector<size_t> LinearEquationSystem::RemoveEmptyColumns() noexcept {
+    std::vector<size_t> kept;
+    for(size_t col = 0; col < vars_; ++col) {
+        if (std::any_of(data_.begin(), data_.end(), [&](const std::vector<Large>& row) { return row[col] != 0; })) {
+            kept.push_back(col);
+        }
+    }
+    if (kept.size() == vars_) {
+        return kept;
+    }
+    for(std::vector<Large>& row : data_) {
+        for(size_t col = 0; col < kept.size(); ++col) {
+            std::swap(row[col], row[kept[col]]);
+        }
+        row.erase(row.begin() + static_cast<std::ptrdiff_t>(kept.size()), row.begin() + static_cast<std::ptrdiff_t>(vars_));
+    }
+    cols_ -= vars_ - kept.size();
+    vars_ = kept.size();
+    return kept;
+}
+
+void LinearEquationSystem::RestoreColumns(const std::vector<size_t>& kept, size_t vars) noexcept {
+    for(std::vector<Large>& row : data_) {
+        row.insert(row.begin() + static_cast<std::ptrdiff_t>(vars_), vars - vars_, Large(0));
+        for(size_t col = vars_; col-- > 0;) {
+            std::swap(row[col], row[kept[col]]);
+        }
+    }
+    for(size_t& pivot : pivots_) {
+        pivot = kept[pivot];
+    }
+    cols_ += vars - vars_;
+    vars_ = vars;
+}
+
+void LinearEquationSystem::Solve(PivotStrategy strategy) noexcept {
+    history_.clear();
+    for(size_t row = 0; row < rows_; ++row) {
+        SimplifyRow(row);
+    }
+
+    rejected_ = !Presolve();
+    rank_.reset();
+    if (rejected_) {
+        pivots_.clear();
+        consistent_ = false;
+        solved_ = recorded_ = true;
         return;
     }
 
-    for(size_t row = non_zeros.size() - 1; row > 0; --row) {
-        for(size_t other = 0; other < row; ++other) {
-            if (data_[other][non_zeros[row]] == 0) {
+    std::optional<SolveKey> key = MakeSolveKey(strategy, vars_, data_);
+    if (key) {
+        SolveCache& cache = GetSolveCache();
+        std::lock_guard lock(cache.mutex);
+        if (const SolveResult* result = cache.entries.Find(*key)) {
+            ++cache.hits;
+            data_ = result->data;
+            pivots_ = result->pivots;
+            consistent_ = solved_ = true;
+            recorded_ = false;
+            return;
+        }
+        ++cache.misses;
+    }
+
+    // empty columns never hold a pivot, so they are left out of the elimination
+    const size_t vars = vars_;
+    const std::vector<size_t> kept = RemoveEmptyColumns();
+    MakeStepwise(strategy);
+    MakeBetterStepwise();
+    if (vars_ != vars) {
+        RestoreColumns(kept, vars);
+    }
+
+    consistent_ = true;
+    for(size_t row = pivots_.size(); row < rows_ && consistent_; ++row) {
+        consistent_ = IsZeroRow(row);
+    }
+    solved_ = true;
+    recorded_ = true;
+
+    if (key && consistent_) {
+        SolveCache& cache = GetSolveCache();
+        std::lock_guard lock(cache.mutex);
+        cache.entries.Insert(std::move(*key), SolveResult{ data_, pivots_ });
+    }
+}
+
+void LinearEquationSystem::EnableCache(size_t capacity) {
+    SolveCache& cache = GetSolveCache();
+    std::lock_guard lock(cache.mutex);
+    cache.entries = LRUCache<SolveKey, SolveResult, SolveKeyHash>(capacity);
+    cache.hits = cache.misses = 0;
+}
+
+LinearEquationSystem::CacheStats LinearEquationSystem::GetCacheStats() noexcept {
+    SolveCache& cache = GetSolveCache();
+    std::lock_guard lock(cache.mutex);
+    return { cache.hits, cache.misses, cache.entries.Size(), cache.entries.Capacity() };
+}
+
+void LinearEquationSystem::SolveBlocked() noexcept {
+    for(size_t row = 0; row < rows_; ++row) {
+        SimplifyRow(row);
+    }
+    const size_t rank = EliminateBlock(0, rows_);
+    history_.clear();
+    rejected_ = false;
+
+    pivots_.resize(rank);
+    for(size_t row = 0; row < rank; ++row) {
+        pivots_[row] = LeadingColumn(row);
+    }
+    consistent_ = true;
+    for(size_t row = rank; row < rows_ && consistent_; ++row) {
+        consistent_ = IsZeroRow(row);
+    }
+    solved_ = true;
+    recorded_ = false;
+}
+
+void LinearEquationSystem::SolveRational() noexcept {
+    Matrix<Rational> reduced(rows_, cols_);
+    reduced.ForEach([&](size_t i, size_t j, Rational& elem) {
+        elem = data_[i][j];
+    });
+    pivots_ = reduced.RowReduce(vars_);
+
+    // every row is scaled back to integers by the common denominator of its entries
+    for(size_t row = 0; row < rows_; ++row) {
+        Large common = 1;
+        reduced.ForRow(row, [&](size_t, Rational& elem) {
+            const Large& denominator = elem.denominator();
+            common = common / gcd(common, denominator) * denominator;
+        });
+        reduced.ForRow(row, [&](size_t col, Rational& elem) {
+            data_[row][col] = elem.numerator() * (common / elem.denominator());
+        });
+        SimplifyRow(row);
+    }
+    history_.clear();
+
+    consistent_ = true;
+    for(size_t row = pivots_.size(); row < rows_ && consistent_; ++row) {
+        consistent_ = IsZeroRow(row);
+    }
+    solved_ = true;
+    recorded_ = rejected_ = false;
+}
+
+size_t LinearEquationSystem::EliminateBlock(size_t begin, size_t end) noexcept {
+    if (end - begin <= block_rows_) {
+        std::vector<size_t> pivots;
+        for(size_t row = begin; row < end; ++row) {
+            for(size_t pivot = 0; pivot < pivots.size(); ++pivot) {
+                EliminateColumn(row, begin + pivot, pivots[pivot]);
+            }
+            const size_t column = LeadingColumn(row);
+            if (column == vars_) {
                 continue;
             }
-            Large gcd_ = gcd(data_[row][non_zeros[row]], data_[other][non_zeros[row]]);
-            Large leading = data_[other][non_zeros[row]];
-            ForRow(other, [&](size_t col, Large& elem) {
-                elem = elem * data_[row][non_zeros[row]] / gcd_ - data_[row][col] * leading / gcd_;
-            });
-            SimplifyRow(other);
+            for(size_t pivot = 0; pivot < pivots.size(); ++pivot) {
+                EliminateColumn(begin + pivot, row, column);
+            }
+            const size_t position = std::lower_bound(pivots.begin(), pivots.end(), column) - pivots.begin();
+            MoveRow(row, begin + position);
+            pivots.insert(pivots.begin() + static_cast<std::ptrdiff_t>(position), column);
+        }
+        return pivots.size();
+    }
+
+    const size_t middle = begin + (end - begin) / 2;
+    const size_t upper_rank = EliminateBlock(begin, middle);
+    ReduceBlock(middle, end, begin, begin + upper_rank);
+    const size_t lower_rank = EliminateBlock(middle, end);
+    ReduceBlock(begin, begin + upper_rank, middle, middle + lower_rank);
+
+    std::vector<std::vector<Large>> merged;
+    merged.reserve(end - begin);
+    size_t upper = begin, lower = middle;
+    while (upper < begin + upper_rank || lower < middle + lower_rank) {
+        if (lower == middle + lower_rank ||
+            (upper < begin + upper_rank && LeadingColumn(upper) < LeadingColumn(lower))) {
+            merged.push_back(std::move(data_[upper++]));
+        } else {
+            merged.push_back(std::move(data_[lower++]));
+        }
+    }
+    for(size_t row = begin + upper_rank; row < middle; ++row) {
+        merged.push_back(std::move(data_[row]));
+    }
+    for(size_t row = middle + lower_rank; row < end; ++row) {
+        merged.push_back(std::move(data_[row]));
+    }
+    std::move(merged.begin(), merged.end(), data_.begin() + static_cast<std::ptrdiff_t>(begin));
+    return upper_rank + lower_rank;
+}
+
+void LinearEquationSystem::ReduceBlock(size_t begin, size_t end, size_t pivot_begin, size_t pivot_end) noexcept {
+    if (begin == end || pivot_begin == pivot_end) {
+        return;
+    }
+    std::vector<size_t> columns;
+    Large lcm = 1;
+    for(size_t row = pivot_begin; row < pivot_end; ++row) {
+        columns.push_back(LeadingColumn(row));
+        const Large& leading = data_[row][columns.back()];
+        if (lcm % leading != 0) {
+            lcm = lcm * leading / gcd(lcm, leading);
+        }
+    }
+
+    Matrix<Large> factors(end - begin, pivot_end - pivot_begin), pivot_rows(pivot_end - pivot_begin, cols_);
+    std::vector<bool> affected(end - begin, false);
+    pivot_rows.ForEach([&](size_t i, size_t j, Large& elem) {
+        elem = data_[pivot_begin + i][j];
+    });
+    for(size_t k = 0; k < columns.size(); ++k) {
+        const Large scale = lcm / data_[pivot_begin + k][columns[k]];
+        for(size_t i = 0; i < end - begin; ++i) {
+            if (data_[begin + i][columns[k]] != 0) {
+                factors(i, k) = data_[begin + i][columns[k]] * scale;
+                affected[i] = true;
+            }
+        }
+    }
+    if (std::find(affected.begin(), affected.end(), true) == affected.end()) {
+        return;
+    }
+
+    Matrix<Large> update = factors * pivot_rows;
+    for(size_t i = 0; i < end - begin; ++i) {
+        if (!affected[i]) {
+            continue;
         }
+        ForRow(begin + i, [&](size_t col, Large& elem) {
+            elem = elem * lcm - update(i, col);
+        });
+        SimplifyRow(begin + i);
     }
 }
 
-void LinearEquationSystem::Solve() noexcept {
+bool LinearEquationSystem::SolveMixed() noexcept {
+    if (rows_ != vars_ || rows_ == 0) {
+        Solve();
+        return false;
+    }
+    Matrix<double> lu(rows_, vars_);
+    lu.ForEach([&](size_t i, size_t j, double& elem) {
+        elem = static_cast<double>(data_[i][j]);
+    });
+    std::vector<size_t> permutation;
+    try {
+        permutation = lu.FactorizeLU();
+    } catch (const std::logic_error&) {
+        Solve();
+        return false;
+    }
+    double min_pivot = std::numeric_limits<double>::infinity(), max_pivot = 0;
+    for(size_t i = 0; i < rows_; ++i) {
+        min_pivot = std::min(min_pivot, std::abs(lu(i, i)));
+        max_pivot = std::max(max_pivot, std::abs(lu(i, i)));
+    }
+    if (!std::isfinite(max_pivot) || min_pivot * 1e12 < max_pivot) {
+        Solve();
+        return false;
+    }
+
+    std::vector<std::vector<Large>> numerators(cols_ - vars_);
+    std::vector<Large> denominators(cols_ - vars_);
+    Large lcm = 1;
+    for(size_t column = 0; column < numerators.size(); ++column) {
+        if (!RefineSolution(lu, permutation, column, numerators[column], denominators[column])) {
+            Solve();
+            return false;
+        }
+        if (lcm % denominators[column] != 0) {
+            lcm = lcm * denominators[column] / gcd(lcm, denominators[column]);
+        }
+    }
+
+    for(size_t row = 0; row < rows_; ++row) {
+        for(size_t col = 0; col < vars_; ++col) {
+            data_[row][col] = col == row ? lcm : 0;
+        }
+        for(size_t index = 0; index < numerators.size(); ++index) {
+            data_[row][vars_ + index] = numerators[index][row] * (lcm / denominators[index]);
+        }
+    }
+    history_.clear();
     for(size_t row = 0; row < rows_; ++row) {
         SimplifyRow(row);
     }
-    MakeStepwise();
-    MakeBetterStepwise();
+    pivots_.resize(rows_);
+    for(size_t row = 0; row < rows_; ++row) {
+        pivots_[row] = row;
+    }
+    consistent_ = true;
+    solved_ = true;
+    recorded_ = rejected_ = false;
+    return true;
 }
 
-std::vector<LinearSolution> LinearEquationSystem::GetSolutions() const noexcept {
-    std::vector<LinearSolution> solutions;
+bool LinearEquationSystem::RefineSolution(const Matrix<double>& lu, const std::vector<size_t>& permutation,
+                                          size_t column, std::vector<Large>& solution, Large& common) const noexcept {
+    double hadamard = 0;
+    for(size_t col = 0; col < vars_; ++col) {
+        double norm = 0;
+        for(size_t row = 0; row < rows_; ++row) {
+            norm += std::pow(2, 2 * Log2(data_[row][col]));
+        }
+        hadamard += std::log2(norm) / 2;
+    }
+    const double precision_limit = 3 * hadamard + std::log2(static_cast<double>(rows_)) + 64;
+
+    std::vector<Large> residual(rows_), numerator(rows_, 0);
+    Large denominator = 1;
+    int64_t shifts = 0;
+    double precision = 0, next_attempt = 32, residual_size = -1;
     for(size_t row = 0; row < rows_; ++row) {
-        bool found = false;
-        for (size_t col = 0; col + 1 < cols_; ++col) {
-            if (data_[row][col] == 0) {
-                continue;
+        residual[row] = data_[row][vars_ + column];
+        residual_size = std::max(residual_size, Log2(residual[row]));
+    }
+
+    while (true) {
+        bool exact = true;
+        for(size_t row = 0; row < rows_ && exact; ++row) {
+            exact = residual[row] == 0;
+        }
+        if (exact) {
+            solution = numerator;
+            common = denominator;
+            return true;
+        }
+        if (precision >= next_attempt) {
+            common = 1;
+            solution.assign(rows_, 0);
+            for(size_t row = 0; row < rows_; ++row) {
+                Large scaled = numerator[row] * common;
+                Large nearest = scaled.MultByBase(-shifts);
+                Large error = scaled - nearest * denominator;
+                if (error * 2 > denominator) {
+                    ++nearest;
+                    error -= denominator;
+                } else if (error * -2 > denominator) {
+                    --nearest;
+                    error += denominator;
+                }
+                if (Log2(error) - Log2(denominator) < Log2(common) - precision / 2) {
+                    solution[row] = nearest;
+                    continue;
+                }
+                Large p, q;
+                Reconstruct(numerator[row], denominator, p, q);
+                Large factor = q / gcd(common, q);
+                for(size_t other = 0; other < row; ++other) {
+                    solution[other] *= factor;
+                }
+                common *= factor;
+                solution[row] = p * (common / q);
             }
-            found = true;
-            solutions.emplace_back(data_[row][col], col + 1);
-            for (size_t var_col = col + 1; var_col + 1 < cols_; ++var_col) {
-                if (data_[row][var_col] != 0) {
-                    solutions.back().expression.emplace_back(-data_[row][var_col], var_col + 1);
+
+            bool verified = true;
+            for(size_t row = 0; row < rows_ && verified; ++row) {
+                Large sum = 0;
+                for(size_t col = 0; col < vars_; ++col) {
+                    if (data_[row][col] != 0 && solution[col] != 0) {
+                        sum += data_[row][col] * solution[col];
+                    }
                 }
+                verified = sum == data_[row][vars_ + column] * common;
             }
-            if (data_[row][cols_ - 1] != 0 || solutions.back().expression.empty()) {
-                solutions.back().expression.emplace_back(data_[row][cols_ - 1], 0);
+            if (verified) {
+                return true;
             }
-            break;
+            next_attempt *= 2;
+        }
+        if (precision > precision_limit) {
+            return false;
+        }
+
+        Matrix<double> rhs(rows_, 1);
+        for(size_t row = 0; row < rows_; ++row) {
+            rhs(row, 0) = static_cast<double>(residual[row]);
+        }
+        Matrix<double> correction = lu.SolveLU(permutation, rhs);
+        double max_correction = 0;
+        for(size_t row = 0; row < rows_; ++row) {
+            max_correction = std::max(max_correction, std::abs(correction(row, 0)));
+        }
+        if (!std::isfinite(max_correction)) {
+            return false;
+        }
+        const bool scale = max_correction < 0x1p20;
+        std::vector<Large> step(rows_);
+        for(size_t row = 0; row < rows_; ++row) {
+            step[row] = RoundToLarge(scale ? correction(row, 0) * 1e9 : correction(row, 0));
+        }
+        for(size_t row = 0; row < rows_; ++row) {
+            if (scale) {
+                residual[row] = residual[row].MultByBase(1);
+                numerator[row] = numerator[row].MultByBase(1);
+            }
+            for(size_t col = 0; col < vars_; ++col) {
+                if (data_[row][col] != 0 && step[col] != 0) {
+                    residual[row] -= data_[row][col] * step[col];
+                }
+            }
+            numerator[row] += step[row];
+        }
+        if (scale) {
+            denominator = denominator.MultByBase(1);
+            ++shifts;
+        }
+
+        double next_size = -1;
+        for(size_t row = 0; row < rows_; ++row) {
+            next_size = std::max(next_size, Log2(residual[row]));
+        }
+        const double gain = (scale ? std::log2(1e9) : 0) + residual_size - next_size;
+        if (gain < 1) {
+            return false;
+        }
+        precision += gain;
+        residual_size = next_size;
+    }
+}
+
+bool LinearEquationSystem::AddEquation(const Matrix<Large>& ratio, const Matrix<Large>& rcol) {
+    if (ratio.rows() != 1 || rcol.rows() != 1 || ratio.columns() != vars_ || rcol.columns() != cols_ - vars_) {
+        throw std::length_error("The equation must be a single row matching the sizes of the system");
+    }
+    data_.emplace_back(cols_);
+    for(size_t col = 0; col < cols_; ++col) {
+        data_.back()[col] = col < vars_ ? ratio(0, col) : rcol(0, col - vars_);
+    }
+    const size_t row = rows_++;
+    if (!solved_) {
+        return true;
+    }
+
+    SimplifyRow(row);
+    if (rejected_) {
+        rank_.reset();
+        return false;
+    }
+    for(size_t pivot = 0; pivot < pivots_.size(); ++pivot) {
+        EliminateColumn(row, pivot, pivots_[pivot]);
+    }
+
+    const size_t column = LeadingColumn(row);
+    if (column == vars_) {
+        consistent_ = consistent_ && IsZeroRow(row);
+        return consistent_;
+    }
+    for(size_t pivot = 0; pivot < pivots_.size(); ++pivot) {
+        EliminateColumn(pivot, row, column);
+    }
+
+    const size_t position = std::lower_bound(pivots_.begin(), pivots_.end(), column) - pivots_.begin();
+    MoveRow(row, position);
+    pivots_.insert(pivots_.begin() + static_cast<std::ptrdiff_t>(position), column);
+    return consistent_;
+}
+
+bool LinearEquationSystem::IsConsistent() const noexcept {
+    return consistent_;
+}
+
+size_t LinearEquationSystem::Rank() const noexcept {
+    if (!rejected_) {
+        return pivots_.size();
+    }
+    // a rejected system is not reduced, its rank is computed once on demand
+    if (!rank_) {
+        LinearEquationSystem ratio(GetRatio(), Matrix<Large>(rows_, 0));
+        ratio.MakeStepwise(PivotStrategy::First);
+        rank_ = ratio.pivots_.size();
+    }
+    return *rank_;
+}
+
+std::vector<LinearSolution> LinearEquationSystem::CollectSolutions(const std::vector<Large>& scale,
+                                                                   const std::vector<Large>& column) const noexcept {
+    std::vector<LinearSolution> solutions;
+    for(size_t row = 0; row < rows_; ++row) {
+        size_t col = row < pivots_.size() ? pivots_[row] : LeadingColumn(row);
+        if (col == vars_) {
+            if (column[row] != 0) {
+                return {};
+            }
+            continue;
+        }
+
+        Large gcd_ = gcd(abs(column[row]), abs(data_[row][col] * scale[row]));
+        for (size_t var_col = 0; var_col < vars_ && gcd_ != 1; ++var_col) {
+            if (var_col != col && data_[row][var_col] != 0) {
+                gcd_ = gcd(gcd_, abs(data_[row][var_col] * scale[row]));
+            }
+        }
+
+        solutions.emplace_back(data_[row][col] * scale[row] / gcd_, col + 1);
+        for (size_t var_col = 0; var_col < vars_; ++var_col) {
+            if (var_col != col && data_[row][var_col] != 0) {
+                solutions.back().expression.emplace_back(-data_[row][var_col] * scale[row] / gcd_, var_col + 1);
+            }
+        }
+        if (column[row] != 0 || solutions.back().expression.empty()) {
+            solutions.back().expression.emplace_back(column[row] / gcd_, 0);
         }
-        if (!found && data_[row][cols_ - 1] != 0) return {};
     }
 
     return solutions;
 }
+
+std::vector<LinearSolution> LinearEquationSystem::GetSolutions(size_t index) const noexcept {
+    if (vars_ + index >= cols_ || rejected_) {
+        return {};
+    }
+    std::vector<Large> column(rows_);
+    for(size_t row = 0; row < rows_; ++row) {
+        column[row] = data_[row][vars_ + index];
+    }
+    return CollectSolutions(std::vector<Large>(rows_, 1), column);
+}
+
+std::vector<std::vector<LinearSolution>> LinearEquationSystem::SolveFor(const Matrix<Large>& rcol) const {
+    if (!solved_ || !recorded_) {
+        throw std::logic_error("The system must be solved by Solve() before adding right-hand sides");
+    }
+    if (rcol.rows() != rows_) {
+        throw std::length_error("The right-hand side must have the same number of rows as the system");
+    }
+    if (rejected_) {
+        LinearEquationSystem reduced(*this);
+        reduced.MakeStepwise(PivotStrategy::First);
+        reduced.MakeBetterStepwise();
+        reduced.rejected_ = false;
+        return reduced.SolveFor(rcol);
+    }
+
+    std::vector<std::vector<LinearSolution>> result;
+    for(size_t index = 0; index < rcol.columns(); ++index) {
+        std::vector<Large> numerator(rows_), denominator(rows_, 1);
+        for(size_t row = 0; row < rows_; ++row) {
+            numerator[row] = rcol(row, index);
+        }
+
+        for(const auto& operation : history_) {
+            const size_t i = operation.row, j = operation.other;
+            switch (operation.type) {
+                case RowOperation::Swap:
+                    std::swap(numerator[i], numerator[j]);
+                    std::swap(denominator[i], denominator[j]);
+                    break;
+                case RowOperation::Move:
+                    MoveEntry(numerator, i, j);
+                    MoveEntry(denominator, i, j);
+                    break;
+                case RowOperation::Combine:
+                    if (denominator[i] == denominator[j]) {
+                        numerator[i] = numerator[i] * operation.lhs - numerator[j] * operation.rhs;
+                    } else {
+                        numerator[i] = numerator[i] * operation.lhs * denominator[j] -
+                                       numerator[j] * operation.rhs * denominator[i];
+                        denominator[i] *= denominator[j];
+                    }
+                    break;
+                case RowOperation::Divide:
+                    denominator[i] *= operation.lhs;
+                    break;
+            }
+            if (operation.type != RowOperation::Swap && operation.type != RowOperation::Move &&
+                denominator[i] != 1) {
+                if (denominator[i] < 0) {
+                    if (numerator[i] != 0) {
+                        numerator[i] = -numerator[i];
+                    }
+                    denominator[i] = -denominator[i];
+                }
+                Large gcd_ = gcd(denominator[i], abs(numerator[i]));
+                if (gcd_ != 1) {
+                    numerator[i] /= gcd_;
+                    denominator[i] /= gcd_;
+                }
+            }
+        }
+        result.push_back(CollectSolutions(denominator, numerator));
+    }
+    return result;
+}
@@ -3,6 +3,7 @@
 #include "Matrix.t.h"
 #include "Large.h"
 #include <numeric>
+#include <optional>
 #include <utility>
 #include <cstdint>
 
@@ -21,10 +22,19 @@ struct LinearSolution {
 
 class LinearEquationSystem : Matrix<Large> {
 public:
+    enum class PivotStrategy { First, SmallestSize, Markowitz, Full };
+
+    struct CacheStats {
+        size_t hits = 0, misses = 0, size = 0, capacity = 0;
+    };
+
     LinearEquationSystem(const Matrix<Large>& ratio, const Matrix<Large>& rcol) :
-        Matrix<Large>(ratio.rows(), ratio.columns() + 1) {
+        Matrix<Large>(ratio.rows(), ratio.columns() + rcol.columns()), vars_(ratio.columns()) {
+        if (ratio.rows() != rcol.rows()) {
+            throw std::length_error("The ratio matrix and the right-hand side must have the same number of rows");
+        }
         ForEach([&](size_t i, size_t j, Large& elem) {
-            elem = j < ratio.columns() ? ratio(i, j) : rcol(i, 0);
+            elem = j < vars_ ? ratio(i, j) : rcol(i, j - vars_);
         });
     }
 
@@ -32,21 +42,107 @@ public:
 
     [[nodiscard]] Matrix<Large> GetColumn() const noexcept;
 
-    void Solve() noexcept;
+    void Solve(PivotStrategy strategy = PivotStrategy::First) noexcept;
+
+    bool SolveMixed() noexcept;
+
+    void SolveBlocked() noexcept;
+
+    void SolveRational() noexcept;
+
+    bool AddEquation(const Matrix<Large>& ratio, const Matrix<Large>& rcol);
+
+    [[nodiscard]] bool IsConsistent() const noexcept;
+
+    [[nodiscard]] size_t Rank() const noexcept;
 
-    [[nodiscard]] std::vector<LinearSolution> GetSolutions() const noexcept;
+    [[nodiscard]] std::vector<LinearSolution> GetSolutions(size_t index = 0) const noexcept;
+
+    [[nodiscard]] std::vector<std::vector<LinearSolution>> SolveFor(const Matrix<Large>& rcol) const;
+
+    static void EnableCache(size_t capacity);
+
+    [[nodiscard]] static CacheStats GetCacheStats() noexcept;
 
     friend std::ostream& operator<<(std::ostream& out, const LinearEquationSystem& les);
 private:
+    struct RowOperation {
+        enum Type { Swap, Move, Combine, Divide };
+
+        Type type;
+        size_t row, other;
+        Large lhs, rhs;
+
+        RowOperation(Type type_, size_t row_, size_t other_, Large lhs_ = 0, Large rhs_ = 0) :
+            type(type_), row(row_), other(other_), lhs(std::move(lhs_)), rhs(std::move(rhs_)) { }
+    };
+
+    size_t vars_;
+    bool solved_ = false, consistent_ = true, recorded_ = false, rejected_ = false;
+    mutable std::optional<size_t> rank_;
+    std::vector<size_t> pivots_;
+    std::vector<RowOperation> history_;
+
+    static const size_t block_rows_ = 8;
+    static const size_t probe_rows_ = 8;
+
     void SwapRows(size_t i, size_t j) noexcept;
 
-    void MakeStepwise() noexcept;
+    void MoveRow(size_t from, size_t to) noexcept;
+
+    void EliminateColumn(size_t row, size_t pivot_row, size_t column,
+                         std::vector<Large::Transform>* transforms = nullptr) noexcept;
+
+    size_t EliminateBlock(size_t begin, size_t end) noexcept;
+
+    void ReduceBlock(size_t begin, size_t end, size_t pivot_begin, size_t pivot_end) noexcept;
+
+    [[nodiscard]] size_t LeadingColumn(size_t row) const noexcept;
+
+    [[nodiscard]] bool IsZeroRow(size_t row) const noexcept;
+
+    void CombineRows(size_t row, size_t other, const Large& lhs, const Large& rhs,
+                     std::vector<Large::Transform>* transforms = nullptr) noexcept;
+
+    [[nodiscard]] bool RefineSolution(const Matrix<double>& lu, const std::vector<size_t>& permutation,
+                                      size_t column, std::vector<Large>& solution, Large& common) const noexcept;
+
+    [[nodiscard]] std::vector<LinearSolution> CollectSolutions(const std::vector<Large>& scale,
+                                                               const std::vector<Large>& column) const noexcept;
+
+    [[nodiscard]] size_t CountNonZeros(size_t row, const std::vector<bool>& used) const noexcept;
+
+    [[nodiscard]] bool SelectPivot(PivotStrategy strategy, size_t upper_row, size_t& pivot_row,
+                                   size_t& pivot_column) const noexcept;
+
+    [[nodiscard]] bool Presolve() noexcept;
+
+    std::vector<size_t> RemoveEmptyColumns() noexcept;
+
+    void RestoreColumns(const std::vector<size_t>& kept, size_t vars) noexcept;
+
+    void MakeStepwise(PivotStrategy strategy) noexcept;
 
     void MakeBetterStepwise() noexcept;
 
     void SimplifyRow(size_t row) noexcept;
 
+    static void MoveEntry(std::vector<Large>& entries, size_t from, size_t to) noexcept {
+        if (from < to) {
+            std::rotate(entries.begin() + from, entries.begin() + from + 1, entries.begin() + to + 1);
+        } else if (to < from) {
+            std::rotate(entries.begin() + to, entries.begin() + from, entries.begin() + from + 1);
+        }
+    }
+
     [[nodiscard]] Large gcd(const Large& a, const Large& b) const noexcept {
+        if (a.Size() == 1 && b.Size() == 1) {
+            int64_t x = static_cast<int64_t>(a), y = static_cast<int64_t>(b);
+            while (y != 0) {
+                x = std::exchange(y, x % y);
+            }
+            return x;
+        }
         if (b == 0) {
             return a;
         }
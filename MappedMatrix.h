@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+#include "Matrix.h"
+
+template<class T> requires std::is_trivially_copyable_v<T>
+class MappedMatrix {
+public:
+#pragma region Constructors
+    MappedMatrix(const std::string& path, size_t rows, size_t cols, size_t panel_rows = 256, size_t cached_panels = 4);
+
+    MappedMatrix(const MappedMatrix<T>& other) = delete;
+
+    MappedMatrix(MappedMatrix<T>&& other) noexcept;
+
+    ~MappedMatrix();
+
+    static MappedMatrix<T> FromMatrix(const Matrix<T>& matrix, const std::string& path, size_t panel_rows = 256,
+                                      size_t cached_panels = 4);
+
+    static MappedMatrix<T> Open(const std::string& path, size_t cols, size_t panel_rows = 256, size_t cached_panels = 4);
+#pragma endregion
+
+#pragma region Getters
+    [[nodiscard]] size_t rows() const noexcept {
+        return rows_;
+    }
+
+    [[nodiscard]] size_t columns() const noexcept {
+        return cols_;
+    }
+
+    [[nodiscard]] size_t panel_rows() const noexcept {
+        return panel_rows_;
+    }
+
+    [[nodiscard]] size_t panels() const noexcept {
+        return cols_ == 0 ? 0 : (rows_ + panel_rows_ - 1) / panel_rows_;
+    }
+
+    T operator()(size_t row, size_t col) const;
+#pragma endregion
+
+    MappedMatrix<T>& operator=(const MappedMatrix<T>& other) = delete;
+
+    void Set(size_t row, size_t col, const T& value);
+
+    T* Panel(size_t panel);
+
+    const T* Panel(size_t panel) const;
+
+    void Flush() const;
+
+    [[nodiscard]] Matrix<T> ToMatrix() const;
+
+    MappedMatrix<T> Transposed(const std::string& path) const;
+
+    MappedMatrix<T> Multiply(const MappedMatrix<T>& other, const std::string& path) const;
+
+private:
+    struct CachedPanel {
+        size_t panel;
+        char* mapping;
+        size_t length;
+        size_t last_use;
+    };
+
+    int fd_;
+    std::string path_;
+    size_t rows_, cols_, panel_rows_, cached_panels_;
+    mutable std::vector<CachedPanel> cache_;
+    mutable size_t clock_ = 0;
+
+    MappedMatrix(int fd, const std::string& path, size_t rows, size_t cols, size_t panel_rows, size_t cached_panels);
+
+    T* MapPanel(size_t panel) const;
+
+    [[nodiscard]] bool IsBackedBy(const std::string& path) const noexcept;
+
+    [[nodiscard]] size_t PanelBegin(size_t panel) const noexcept {
+        return panel * panel_rows_ * cols_ * sizeof(T);
+    }
+
+    [[nodiscard]] size_t PanelEnd(size_t panel) const noexcept {
+        return std::min(rows_, (panel + 1) * panel_rows_) * cols_ * sizeof(T);
+    }
+};
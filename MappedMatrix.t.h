@@ -0,0 +1,230 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "MappedMatrix.h"
+
+template<class T> requires std::is_trivially_copyable_v<T>
+MappedMatrix<T>::MappedMatrix(const std::string& path, size_t rows, size_t cols, size_t panel_rows,
+                              size_t cached_panels) :
+    path_(path), rows_(rows), cols_(cols), panel_rows_(std::max<size_t>(panel_rows, 1)),
+    cached_panels_(std::max<size_t>(cached_panels, 2)) {
+    fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        throw std::system_error(errno, std::generic_category(), "Cannot open " + path);
+    }
+    if (ftruncate(fd_, static_cast<off_t>(rows_ * cols_ * sizeof(T))) != 0) {
+        const int error = errno;
+        close(fd_);
+        throw std::system_error(error, std::generic_category(), "Cannot resize " + path);
+    }
+}
+
+template<class T> requires std::is_trivially_copyable_v<T>
+MappedMatrix<T>::MappedMatrix(int fd, const std::string& path, size_t rows, size_t cols, size_t panel_rows,
+                              size_t cached_panels) :
+    fd_(fd), path_(path), rows_(rows), cols_(cols), panel_rows_(std::max<size_t>(panel_rows, 1)),
+    cached_panels_(std::max<size_t>(cached_panels, 2)) {}
+
+template<class T> requires std::is_trivially_copyable_v<T>
+MappedMatrix<T>::MappedMatrix(MappedMatrix<T>&& other) noexcept :
+    fd_(std::exchange(other.fd_, -1)), path_(std::move(other.path_)), rows_(other.rows_), cols_(other.cols_), panel_rows_(other.panel_rows_),
+    cached_panels_(other.cached_panels_), cache_(std::exchange(other.cache_, {})), clock_(other.clock_) {}
+
+template<class T> requires std::is_trivially_copyable_v<T>
+MappedMatrix<T>::~MappedMatrix() {
+    for(const CachedPanel& entry : cache_) {
+        munmap(entry.mapping, entry.length);
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+template<class T> requires std::is_trivially_copyable_v<T>
+MappedMatrix<T> MappedMatrix<T>::FromMatrix(const Matrix<T>& matrix, const std::string& path, size_t panel_rows,
+                                            size_t cached_panels) {
+    MappedMatrix<T> result(path, matrix.rows(), matrix.columns(), panel_rows, cached_panels);
+    for(size_t panel = 0; panel < result.panels(); ++panel) {
+        T* data = result.Panel(panel);
+        const size_t begin = panel * result.panel_rows_, end = std::min(result.rows_, begin + result.panel_rows_);
+        for(size_t row = begin; row < end; ++row) {
+            for(size_t col = 0; col < result.cols_; ++col) {
+                data[(row - begin) * result.cols_ + col] = matrix(row, col);
+            }
+        }
+    }
+    return result;
+}
+
+template<class T> requires std::is_trivially_copyable_v<T>
+MappedMatrix<T> MappedMatrix<T>::Open(const std::string& path, size_t cols, size_t panel_rows, size_t cached_panels) {
+    if (cols == 0) {
+        throw std::invalid_argument("Cannot infer the number of rows without columns");
+    }
+    const int fd = open(path.c_str(), O_RDWR);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "Cannot open " + path);
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0) {
+        const int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), "Cannot stat " + path);
+    }
+    const size_t size = static_cast<size_t>(info.st_size), row_size = cols * sizeof(T);
+    if (size % row_size != 0) {
+        close(fd);
+        throw std::length_error("File size of " + path + " is not a multiple of the row size");
+    }
+    return MappedMatrix<T>(fd, path, size / row_size, cols, panel_rows, cached_panels);
+}
+
+template<class T> requires std::is_trivially_copyable_v<T>
+bool MappedMatrix<T>::IsBackedBy(const std::string& path) const noexcept {
+    std::error_code error;
+    return path == path_ || std::filesystem::equivalent(path, path_, error);
+}
+
+template<class T> requires std::is_trivially_copyable_v<T>
+T* MappedMatrix<T>::MapPanel(size_t panel) const {
+    if (panel >= panels()) {
+        throw std::out_of_range("Panel out of range");
+    }
+    const size_t begin = PanelBegin(panel);
+    auto it = std::find_if(cache_.begin(), cache_.end(), [&](const CachedPanel& entry) {
+        return entry.panel == panel;
+    });
+    if (it == cache_.end()) {
+        if (cache_.size() == cached_panels_) {
+            it = std::min_element(cache_.begin(), cache_.end(), [](const CachedPanel& lhs, const CachedPanel& rhs) {
+                return lhs.last_use < rhs.last_use;
+            });
+            munmap(it->mapping, it->length);
+            cache_.erase(it);
+        }
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t aligned = begin / page * page, length = PanelEnd(panel) - aligned;
+        void* mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, static_cast<off_t>(aligned));
+        if (mapping == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "Cannot map panel");
+        }
+        cache_.push_back({ panel, static_cast<char*>(mapping), length, 0 });
+        it = cache_.end() - 1;
+
+        if (panel + 1 < panels()) {
+            posix_fadvise(fd_, static_cast<off_t>(PanelBegin(panel + 1)),
+                          static_cast<off_t>(PanelEnd(panel + 1) - PanelBegin(panel + 1)), POSIX_FADV_WILLNEED);
+        }
+    }
+    it->last_use = ++clock_;
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return reinterpret_cast<T*>(it->mapping + (begin - begin / page * page));
+}
+
+template<class T> requires std::is_trivially_copyable_v<T>
+T* MappedMatrix<T>::Panel(size_t panel) {
+    return MapPanel(panel);
+}
+
+template<class T> requires std::is_trivially_copyable_v<T>
+const T* MappedMatrix<T>::Panel(size_t panel) const {
+    return MapPanel(panel);
+}
+
+template<class T> requires std::is_trivially_copyable_v<T>
+T MappedMatrix<T>::operator()(size_t row, size_t col) const {
+    if (row >= rows_ || col >= cols_) {
+        throw std::out_of_range("Index out of range");
+    }
+    return Panel(row / panel_rows_)[row % panel_rows_ * cols_ + col];
+}
+
+template<class T> requires std::is_trivially_copyable_v<T>
+void MappedMatrix<T>::Set(size_t row, size_t col, const T& value) {
+    if (row >= rows_ || col >= cols_) {
+        throw std::out_of_range("Index out of range");
+    }
+    Panel(row / panel_rows_)[row % panel_rows_ * cols_ + col] = value;
+}
+
+template<class T> requires std::is_trivially_copyable_v<T>
+void MappedMatrix<T>::Flush() const {
+    for(const CachedPanel& entry : cache_) {
+        msync(entry.mapping, entry.length, MS_SYNC);
+    }
+}
+
+template<class T> requires std::is_trivially_copyable_v<T>
+Matrix<T> MappedMatrix<T>::ToMatrix() const {
+    Matrix<T> result(rows_, cols_);
+    for(size_t panel = 0; panel < panels(); ++panel) {
+        const T* data = Panel(panel);
+        const size_t begin = panel * panel_rows_, end = std::min(rows_, begin + panel_rows_);
+        for(size_t row = begin; row < end; ++row) {
+            for(size_t col = 0; col < cols_; ++col) {
+                result(row, col) = data[(row - begin) * cols_ + col];
+            }
+        }
+    }
+    return result;
+}
+
+template<class T> requires std::is_trivially_copyable_v<T>
+MappedMatrix<T> MappedMatrix<T>::Transposed(const std::string& path) const {
+    if (IsBackedBy(path)) {
+        throw std::invalid_argument("Result cannot be written over the operand " + path);
+    }
+    MappedMatrix<T> result(path, cols_, rows_, panel_rows_, cached_panels_);
+    for(size_t panel = 0; panel < panels(); ++panel) {
+        const size_t row_begin = panel * panel_rows_, row_end = std::min(rows_, row_begin + panel_rows_);
+        for(size_t other = 0; other < result.panels(); ++other) {
+            T* target = result.Panel(other);
+            const T* source = Panel(panel);
+            const size_t col_begin = other * panel_rows_, col_end = std::min(cols_, col_begin + panel_rows_);
+            for(size_t row = row_begin; row < row_end; ++row) {
+                for(size_t col = col_begin; col < col_end; ++col) {
+                    target[(col - col_begin) * rows_ + row] = source[(row - row_begin) * cols_ + col];
+                }
+            }
+        }
+    }
+    return result;
+}
+
+template<class T> requires std::is_trivially_copyable_v<T>
+MappedMatrix<T> MappedMatrix<T>::Multiply(const MappedMatrix<T>& other, const std::string& path) const {
+    if (cols_ != other.rows_) {
+        throw std::length_error("Matrices have incompatible sizes for multiplication");
+    }
+    if (IsBackedBy(path) || other.IsBackedBy(path)) {
+        throw std::invalid_argument("Result cannot be written over the operand " + path);
+    }
+    MappedMatrix<T> result(path, rows_, other.cols_, panel_rows_, cached_panels_);
+    for(size_t panel = 0; panel < panels(); ++panel) {
+        const size_t row_begin = panel * panel_rows_, row_end = std::min(rows_, row_begin + panel_rows_);
+        for(size_t inner = 0; inner < other.panels(); ++inner) {
+            const T* rhs = other.Panel(inner);
+            const T* lhs = Panel(panel);
+            T* target = result.Panel(panel);
+            const size_t k_begin = inner * other.panel_rows_, k_end = std::min(other.rows_, k_begin + other.panel_rows_);
+            for(size_t row = row_begin; row < row_end; ++row) {
+                T* target_row = target + (row - row_begin) * other.cols_;
+                for(size_t k = k_begin; k < k_end; ++k) {
+                    const T factor = lhs[(row - row_begin) * cols_ + k];
+                    const T* rhs_row = rhs + (k - k_begin) * other.cols_;
+                    for(size_t col = 0; col < other.cols_; ++col) {
+                        target_row[col] += factor * rhs_row[col];
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
@@ -3,8 +3,20 @@
 #include <vector>
 #include <utility>
 #include <iostream>
+#include <optional>
+#include <concepts>
+#include <execution>
+#include <type_traits>
 #include <functional>
 
+class Rational;
+
+template<class Policy>
+concept ExecutionPolicy = std::is_execution_policy_v<std::remove_cvref_t<Policy>>;
+
+template<class T>
+concept ExactDivision = std::floating_point<T> || std::same_as<T, Rational>;
+
 template<class T>
 class Matrix {
 public:
@@ -143,16 +155,48 @@ public:
     }
 #pragma endregion
 
-    Matrix<T>& ForEach(std::function<void(size_t, size_t, T&)> func);
+    template<std::invocable<size_t, size_t, T&> Func>
+    Matrix<T>& ForEach(Func&& func);
+
+    template<ExecutionPolicy Policy, std::invocable<size_t, size_t, T&> Func>
+    Matrix<T>& ForEach(Policy&& policy, Func&& func);
+
+    template<std::invocable<size_t, T&> Func>
+    Matrix<T>& ForRow(size_t row, Func&& func);
 
-    Matrix<T>& ForRow(size_t row, std::function<void(size_t, T&)> func);
+    template<ExecutionPolicy Policy, std::invocable<size_t, T&> Func>
+    Matrix<T>& ForRow(Policy&& policy, size_t row, Func&& func);
 
-    Matrix<T>& ForColumn(size_t col, std::function<void(size_t, T&)> func);
+    template<std::invocable<size_t, T&> Func>
+    Matrix<T>& ForColumn(size_t col, Func&& func);
+
+    template<ExecutionPolicy Policy, std::invocable<size_t, T&> Func>
+    Matrix<T>& ForColumn(Policy&& policy, size_t col, Func&& func);
 
     T Trace() const noexcept;
 
+    [[nodiscard]] size_t Hash() const noexcept;
+
     Matrix<T> Transposed() const noexcept;
 
+    Matrix<T>& Transpose() noexcept;
+
+    [[nodiscard]] std::vector<T> ToRowMajor() const;
+
+    [[nodiscard]] std::vector<T> ToColumnMajor() const;
+
+    static Matrix<T> FromRowMajor(size_t rows, size_t cols, const std::vector<T>& buffer);
+
+    static Matrix<T> FromColumnMajor(size_t rows, size_t cols, const std::vector<T>& buffer);
+
+    std::optional<Matrix<T>> Inverse() const requires ExactDivision<T>;
+
+    std::vector<size_t> RowReduce(size_t columns) requires ExactDivision<T>;
+
+    std::vector<size_t> FactorizeLU(size_t block_size = 32);
+
+    Matrix<T> SolveLU(const std::vector<size_t>& permutation, const Matrix<T>& rhs) const;
+
 #pragma region Friends
     template<class U, class V>
     friend Matrix<U> operator*(V scalar, const Matrix<U>& mat);
@@ -172,4 +216,16 @@ protected:
     size_t rows_, cols_{};
 
     void FitMatrix();
+
+    static constexpr size_t tile_size_ = std::is_arithmetic_v<T> ? 64 / sizeof(T) * 2 : 8;
+
+    template<class Func>
+    static void ForEachTiled(size_t rows, size_t cols, Func&& func);
+};
+
+template<class T>
+struct std::hash<Matrix<T>> {
+    size_t operator()(const Matrix<T>& matrix) const noexcept {
+        return matrix.Hash();
+    }
 };
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <iomanip>
+#include <cmath>
+#include <algorithm>
 #include "Matrix.h"
 
 template<class T>
@@ -62,31 +64,67 @@ std::ostream& operator<<(std::ostream& out, const Matrix<T>& matrix) {
 }
 
 template<class T>
-Matrix<T>& Matrix<T>::ForEach(std::function<void(size_t, size_t, T&)> func) {
+template<std::invocable<size_t, size_t, T&> Func>
+Matrix<T>& Matrix<T>::ForEach(Func&& func) {
     for(size_t i = 0; i < rows_; ++i) {
+        T* row = data_[i].data();
         for(size_t j = 0; j < cols_; ++j) {
-            func(i, j, data_[i][j]);
+            func(i, j, row[j]);
         }
     }
     return *this;
 }
 
 template<class T>
-Matrix<T>& Matrix<T>::ForRow(size_t row, std::function<void(size_t, T&)> func) {
+template<ExecutionPolicy Policy, std::invocable<size_t, size_t, T&> Func>
+Matrix<T>& Matrix<T>::ForEach(Policy&& policy, Func&& func) {
+    std::for_each(std::forward<Policy>(policy), data_.begin(), data_.end(), [&](std::vector<T>& row) {
+        const size_t i = &row - data_.data();
+        for(size_t j = 0; j < cols_; ++j) {
+            func(i, j, row[j]);
+        }
+    });
+    return *this;
+}
+
+template<class T>
+template<std::invocable<size_t, T&> Func>
+Matrix<T>& Matrix<T>::ForRow(size_t row, Func&& func) {
+    T* elements = data_[row].data();
     for(size_t col = 0; col < cols_; ++col) {
-        func(col, data_[row][col]);
+        func(col, elements[col]);
     }
     return *this;
 }
 
 template<class T>
-Matrix<T>& Matrix<T>::ForColumn(size_t col, std::function<void(size_t, T&)> func) {
+template<ExecutionPolicy Policy, std::invocable<size_t, T&> Func>
+Matrix<T>& Matrix<T>::ForRow(Policy&& policy, size_t row, Func&& func) {
+    T* elements = data_[row].data();
+    std::for_each(std::forward<Policy>(policy), data_[row].begin(), data_[row].end(), [&](T& elem) {
+        func(&elem - elements, elem);
+    });
+    return *this;
+}
+
+template<class T>
+template<std::invocable<size_t, T&> Func>
+Matrix<T>& Matrix<T>::ForColumn(size_t col, Func&& func) {
     for(size_t row = 0; row < rows_; ++row) {
         func(row, data_[row][col]);
     }
     return *this;
 }
 
+template<class T>
+template<ExecutionPolicy Policy, std::invocable<size_t, T&> Func>
+Matrix<T>& Matrix<T>::ForColumn(Policy&& policy, size_t col, Func&& func) {
+    std::for_each(std::forward<Policy>(policy), data_.begin(), data_.end(), [&](std::vector<T>& row) {
+        func(&row - data_.data(), row[col]);
+    });
+    return *this;
+}
+
 template<class T, class U>
 Matrix<T> operator*(const U scalar, const Matrix<T>& mat) {
     return mat * scalar;
@@ -112,12 +150,247 @@ T Matrix<T>::Trace() const noexcept {
     return result;
 }
 
+template<class T>
+size_t Matrix<T>::Hash() const noexcept {
+    size_t hash = rows_ * 0x9e3779b97f4a7c15 ^ cols_;
+    for(const std::vector<T>& row : data_) {
+        for(const T& elem : row) {
+            hash ^= std::hash<T>{}(elem) + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+        }
+    }
+    return hash;
+}
+
+template<class T>
+template<class Func>
+void Matrix<T>::ForEachTiled(size_t rows, size_t cols, Func&& func) {
+    for(size_t row_begin = 0; row_begin < rows; row_begin += tile_size_) {
+        const size_t row_end = std::min(row_begin + tile_size_, rows);
+        for(size_t col_begin = 0; col_begin < cols; col_begin += tile_size_) {
+            const size_t col_end = std::min(col_begin + tile_size_, cols);
+            for(size_t i = row_begin; i < row_end; ++i) {
+                for(size_t j = col_begin; j < col_end; ++j) {
+                    func(i, j);
+                }
+            }
+        }
+    }
+}
+
 template<class T>
 Matrix<T> Matrix<T>::Transposed() const noexcept {
     Matrix<T> mat(cols_, rows_);
-    return mat.ForEach([&](size_t i, size_t j, T& elem) {
-        elem = this->data_[j][i];
+    ForEachTiled(rows_, cols_, [&](size_t i, size_t j) {
+        mat.data_[j][i] = data_[i][j];
+    });
+    return mat;
+}
+
+template<class T>
+Matrix<T>& Matrix<T>::Transpose() noexcept {
+    if (rows_ == cols_) {
+        for(size_t row_begin = 0; row_begin < rows_; row_begin += tile_size_) {
+            const size_t row_end = std::min(row_begin + tile_size_, rows_);
+            for(size_t col_begin = row_begin; col_begin < cols_; col_begin += tile_size_) {
+                const size_t col_end = std::min(col_begin + tile_size_, cols_);
+                for(size_t i = row_begin; i < row_end; ++i) {
+                    for(size_t j = std::max(col_begin, i + 1); j < col_end; ++j) {
+                        std::swap(data_[i][j], data_[j][i]);
+                    }
+                }
+            }
+        }
+        return *this;
+    }
+    std::vector<std::vector<T>> data(cols_, std::vector<T>(rows_));
+    ForEachTiled(rows_, cols_, [&](size_t i, size_t j) {
+        data[j][i] = std::move(data_[i][j]);
+    });
+    data_.swap(data);
+    std::swap(rows_, cols_);
+    return *this;
+}
+
+template<class T>
+std::vector<T> Matrix<T>::ToRowMajor() const {
+    std::vector<T> buffer;
+    buffer.reserve(rows_ * cols_);
+    for(const auto& row : data_) {
+        buffer.insert(buffer.end(), row.begin(), row.end());
+    }
+    return buffer;
+}
+
+template<class T>
+std::vector<T> Matrix<T>::ToColumnMajor() const {
+    std::vector<T> buffer(rows_ * cols_);
+    ForEachTiled(rows_, cols_, [&](size_t i, size_t j) {
+        buffer[j * rows_ + i] = data_[i][j];
+    });
+    return buffer;
+}
+
+template<class T>
+Matrix<T> Matrix<T>::FromRowMajor(size_t rows, size_t cols, const std::vector<T>& buffer) {
+    if (buffer.size() != rows * cols) {
+        throw std::length_error("The buffer size does not match the matrix size");
+    }
+    Matrix<T> mat(rows, cols);
+    for(size_t i = 0; i < rows; ++i) {
+        std::copy(buffer.begin() + i * cols, buffer.begin() + (i + 1) * cols, mat.data_[i].begin());
+    }
+    return mat;
+}
+
+template<class T>
+Matrix<T> Matrix<T>::FromColumnMajor(size_t rows, size_t cols, const std::vector<T>& buffer) {
+    if (buffer.size() != rows * cols) {
+        throw std::length_error("The buffer size does not match the matrix size");
+    }
+    Matrix<T> mat(rows, cols);
+    ForEachTiled(rows, cols, [&](size_t i, size_t j) {
+        mat.data_[i][j] = buffer[j * rows + i];
     });
+    return mat;
+}
+
+template<class T>
+std::optional<Matrix<T>> Matrix<T>::Inverse() const requires ExactDivision<T> {
+    if (rows_ != cols_) {
+        return std::nullopt;
+    }
+    Matrix<T> mat(rows_, 2 * cols_);
+    for(size_t i = 0; i < rows_; ++i) {
+        std::copy(data_[i].begin(), data_[i].end(), mat.data_[i].begin());
+        mat.data_[i][cols_ + i] = 1;
+    }
+    if (mat.RowReduce(cols_).size() != rows_) {
+        return std::nullopt;
+    }
+    Matrix<T> result(rows_, cols_);
+    for(size_t i = 0; i < rows_; ++i) {
+        std::copy(mat.data_[i].begin() + cols_, mat.data_[i].end(), result.data_[i].begin());
+    }
+    return result;
+}
+
+template<class T>
+std::vector<size_t> Matrix<T>::RowReduce(size_t columns) requires ExactDivision<T> {
+    std::vector<size_t> pivots;
+    for(size_t col = 0; col < std::min(columns, cols_) && pivots.size() < rows_; ++col) {
+        const size_t top = pivots.size();
+        size_t pivot = top;
+        if constexpr (std::floating_point<T>) {
+            for(size_t row = top + 1; row < rows_; ++row) {
+                if (std::abs(data_[row][col]) > std::abs(data_[pivot][col])) {
+                    pivot = row;
+                }
+            }
+        } else {
+            while (pivot + 1 < rows_ && data_[pivot][col] == 0) {
+                ++pivot;
+            }
+        }
+        if (data_[pivot][col] == 0) {
+            continue;
+        }
+        std::swap(data_[pivot], data_[top]);
+
+        const T leading = data_[top][col];
+        for(size_t j = col; j < cols_; ++j) {
+            data_[top][j] = data_[top][j] / leading;
+        }
+        for(size_t row = 0; row < rows_; ++row) {
+            if (row == top || data_[row][col] == 0) {
+                continue;
+            }
+            const T factor = data_[row][col];
+            for(size_t j = col; j < cols_; ++j) {
+                data_[row][j] = data_[row][j] - factor * data_[top][j];
+            }
+        }
+        pivots.push_back(col);
+    }
+    return pivots;
+}
+
+template<class T>
+std::vector<size_t> Matrix<T>::FactorizeLU(size_t block_size) {
+    if (rows_ != cols_) {
+        throw std::length_error("Only square matrices can be factorized");
+    }
+    using std::abs;
+    std::vector<size_t> permutation(rows_);
+    for(size_t i = 0; i < rows_; ++i) {
+        permutation[i] = i;
+    }
+    for(size_t begin = 0; begin < rows_; begin += block_size) {
+        const size_t end = std::min(begin + block_size, rows_);
+        for(size_t k = begin; k < end; ++k) {
+            size_t pivot = k;
+            for(size_t row = k + 1; row < rows_; ++row) {
+                if (abs(data_[row][k]) > abs(data_[pivot][k])) {
+                    pivot = row;
+                }
+            }
+            if (data_[pivot][k] == 0) {
+                throw std::logic_error("The matrix is singular");
+            }
+            std::swap(data_[pivot], data_[k]);
+            std::swap(permutation[pivot], permutation[k]);
+            for(size_t row = k + 1; row < rows_; ++row) {
+                data_[row][k] = data_[row][k] / data_[k][k];
+                for(size_t col = k + 1; col < end; ++col) {
+                    data_[row][col] = data_[row][col] - data_[row][k] * data_[k][col];
+                }
+            }
+        }
+        for(size_t k = begin; k < end; ++k) {
+            for(size_t row = k + 1; row < end; ++row) {
+                for(size_t col = end; col < cols_; ++col) {
+                    data_[row][col] = data_[row][col] - data_[row][k] * data_[k][col];
+                }
+            }
+        }
+        for(size_t row = end; row < rows_; ++row) {
+            for(size_t k = begin; k < end; ++k) {
+                const T factor = data_[row][k];
+                for(size_t col = end; col < cols_; ++col) {
+                    data_[row][col] = data_[row][col] - factor * data_[k][col];
+                }
+            }
+        }
+    }
+    return permutation;
+}
+
+template<class T>
+Matrix<T> Matrix<T>::SolveLU(const std::vector<size_t>& permutation, const Matrix<T>& rhs) const {
+    if (rows_ != rhs.rows_ || permutation.size() != rows_) {
+        throw std::length_error("The right-hand side must have the same number of rows as the matrix");
+    }
+    Matrix<T> result(rhs.rows_, rhs.cols_);
+    for(size_t row = 0; row < rows_; ++row) {
+        result.data_[row] = rhs.data_[permutation[row]];
+    }
+    for(size_t row = 0; row < rows_; ++row) {
+        for(size_t k = 0; k < row; ++k) {
+            for(size_t col = 0; col < rhs.cols_; ++col) {
+                result.data_[row][col] = result.data_[row][col] - data_[row][k] * result.data_[k][col];
+            }
+        }
+    }
+    for(size_t row = rows_; row-- > 0;) {
+        for(size_t k = row + 1; k < cols_; ++k) {
+            for(size_t col = 0; col < rhs.cols_; ++col) {
+                result.data_[row][col] = result.data_[row][col] - data_[row][k] * result.data_[k][col];
+            }
+        }
+        for(size_t col = 0; col < rhs.cols_; ++col) {
+            result.data_[row][col] = result.data_[row][col] / data_[row][row];
+        }
+    }
+    return result;
 }
 
 template<class T>
@@ -0,0 +1,168 @@
+#include "Rational.h"
+#include <numeric>
+
+namespace {
+    Large gcd(Large a, Large b) noexcept {
+        while (b != 0) {
+            a = std::exchange(b, a % b);
+        }
+        return abs(a);
+    }
+}
+
+Rational::Rational(Large numerator, Large denominator) : numerator_(std::move(numerator)),
+                                                         denominator_(std::move(denominator)),
+                                                         normalized_(false) {
+    if (denominator_ == 0) {
+        throw std::logic_error("Division by zero");
+    }
+    if (denominator_ < 0) {
+        numerator_ = numerator_ == 0 ? numerator_ : -numerator_;
+        denominator_ = -denominator_;
+    }
+}
+
+Rational::Rational(const std::string& value) : Rational(0) {
+    size_t slash = value.find('/');
+    if (slash == std::string::npos) {
+        *this = Rational(Large(value));
+    } else {
+        *this = Rational(Large(value.substr(0, slash)), Large(value.substr(slash + 1)));
+    }
+}
+
+Rational Rational::FromSmall(int64_t numerator, int64_t denominator) noexcept {
+    if (denominator < 0) {
+        numerator = -numerator;
+        denominator = -denominator;
+    }
+    int64_t gcd_ = std::gcd(numerator, denominator);
+    Rational result;
+    result.numerator_ = numerator / gcd_;
+    result.denominator_ = denominator / gcd_;
+    return result;
+}
+
+Rational Rational::FromLarge(Large numerator, Large denominator) noexcept {
+    Rational result;
+    result.numerator_ = std::move(numerator);
+    result.denominator_ = std::move(denominator);
+    if (result.denominator_ < 0) {
+        result.numerator_ = result.numerator_ == 0 ? result.numerator_ : -result.numerator_;
+        result.denominator_ = -result.denominator_;
+    }
+    result.normalized_ = result.denominator_ == 1;
+    if (result.numerator_.Size() + result.denominator_.Size() > max_lazy_size_) {
+        result.Normalize();
+    }
+    return result;
+}
+
+void Rational::Normalize() const noexcept {
+    if (normalized_) {
+        return;
+    }
+    if (numerator_ == 0) {
+        numerator_ = 0;
+        denominator_ = 1;
+    } else {
+        Large gcd_ = gcd(numerator_, denominator_);
+        if (gcd_ != 1) {
+            numerator_ /= gcd_;
+            denominator_ /= gcd_;
+        }
+    }
+    normalized_ = true;
+}
+
+bool Rational::operator==(const Rational& other) const noexcept {
+    if (IsSmall() && other.IsSmall()) {
+        return static_cast<int64_t>(numerator_) * static_cast<int64_t>(other.denominator_) ==
+               static_cast<int64_t>(other.numerator_) * static_cast<int64_t>(denominator_);
+    }
+    if (normalized_ && other.normalized_) {
+        return numerator_ == other.numerator_ && denominator_ == other.denominator_;
+    }
+    return numerator_ * other.denominator_ == other.numerator_ * denominator_;
+}
+
+bool Rational::operator<(const Rational& other) const noexcept {
+    if (IsSmall() && other.IsSmall()) {
+        return static_cast<int64_t>(numerator_) * static_cast<int64_t>(other.denominator_) <
+               static_cast<int64_t>(other.numerator_) * static_cast<int64_t>(denominator_);
+    }
+    if (denominator_ == other.denominator_) {
+        return numerator_ < other.numerator_;
+    }
+    return numerator_ * other.denominator_ < other.numerator_ * denominator_;
+}
+
+Rational Rational::operator+(const Rational& other) const noexcept {
+    if (IsSmall() && other.IsSmall()) {
+        int64_t a = static_cast<int64_t>(numerator_), b = static_cast<int64_t>(denominator_);
+        int64_t c = static_cast<int64_t>(other.numerator_), d = static_cast<int64_t>(other.denominator_);
+        return FromSmall(a * d + c * b, b * d);
+    }
+    if (denominator_ == other.denominator_) {
+        return FromLarge(numerator_ + other.numerator_, denominator_);
+    }
+    return FromLarge(numerator_ * other.denominator_ + other.numerator_ * denominator_,
+                     denominator_ * other.denominator_);
+}
+
+Rational Rational::operator-(const Rational& other) const noexcept {
+    return *this + -other;
+}
+
+Rational Rational::operator*(const Rational& other) const noexcept {
+    if (IsSmall() && other.IsSmall()) {
+        return FromSmall(static_cast<int64_t>(numerator_) * static_cast<int64_t>(other.numerator_),
+                         static_cast<int64_t>(denominator_) * static_cast<int64_t>(other.denominator_));
+    }
+    return FromLarge(numerator_ * other.numerator_, denominator_ * other.denominator_);
+}
+
+Rational Rational::operator/(const Rational& other) const {
+    if (other.numerator_ == 0) {
+        throw std::logic_error("Division by zero");
+    }
+    if (IsSmall() && other.IsSmall()) {
+        return FromSmall(static_cast<int64_t>(numerator_) * static_cast<int64_t>(other.denominator_),
+                         static_cast<int64_t>(denominator_) * static_cast<int64_t>(other.numerator_));
+    }
+    return FromLarge(numerator_ * other.denominator_, denominator_ * other.numerator_);
+}
+
+Rational abs(const Rational& num) noexcept {
+    return num < 0 ? -num : num;
+}
+
+std::string to_string(const Rational& num) noexcept {
+    num.Normalize();
+    if (num.denominator_ == 1) {
+        return to_string(num.numerator_);
+    }
+    return to_string(num.numerator_) + "/" + to_string(num.denominator_);
+}
+
+Rational pow(const Rational& num, const Large& n) {
+    if (n < 0) {
+        return pow(Rational(1) / num, -n);
+    }
+    num.Normalize();
+    Rational result;
+    result.numerator_ = pow(num.numerator_, n);
+    result.denominator_ = pow(num.denominator_, n);
+    return result;
+}
+
+std::istream& operator>>(std::istream& is, Rational& num) {
+    std::string s;
+    is >> s;
+    num = Rational(s);
+    return is;
+}
+
+std::ostream& operator<<(std::ostream& os, const Rational& num) noexcept {
+    return os << to_string(num);
+}
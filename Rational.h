@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Large.h"
+#include <string>
+#include <utility>
+#include <cstdint>
+
+class Rational {
+public:
+    Rational() : numerator_(0), denominator_(1) {}
+
+    Rational(int64_t value) : numerator_(value), denominator_(1) {}
+
+    Rational(Large value) : numerator_(std::move(value)), denominator_(1) {}
+
+    Rational(Large numerator, Large denominator);
+
+    Rational(const std::string& value);
+
+    Rational(const Rational& other) = default;
+
+    Rational(Rational&& other) noexcept = default;
+
+    ~Rational() = default;
+
+    [[nodiscard]] const Large& numerator() const noexcept {
+        Normalize();
+        return numerator_;
+    }
+
+    [[nodiscard]] const Large& denominator() const noexcept {
+        Normalize();
+        return denominator_;
+    }
+
+    [[nodiscard]] bool IsNormalized() const noexcept {
+        return normalized_;
+    }
+
+    void Normalize() const noexcept;
+
+    bool operator==(const Rational& other) const noexcept;
+
+    bool operator!=(const Rational& other) const noexcept {
+        return !(*this == other);
+    }
+
+    bool operator<(const Rational& other) const noexcept;
+
+    bool operator<=(const Rational& other) const noexcept {
+        return !(other < *this);
+    }
+
+    bool operator>(const Rational& other) const noexcept {
+        return other < *this;
+    }
+
+    bool operator>=(const Rational& other) const noexcept {
+        return !(*this < other);
+    }
+
+    Rational operator-() const noexcept {
+        Rational other = *this;
+        if (other.numerator_ != 0) {
+            other.numerator_ = -other.numerator_;
+        }
+        return other;
+    }
+
+    Rational operator+() const noexcept {
+        return *this;
+    }
+
+    Rational& operator=(const Rational& other) = default;
+
+    Rational& operator=(Rational&& other) noexcept = default;
+
+    Rational operator+(const Rational& other) const noexcept;
+
+    Rational operator-(const Rational& other) const noexcept;
+
+    Rational operator*(const Rational& other) const noexcept;
+
+    Rational operator/(const Rational& other) const;
+
+    Rational& operator+=(const Rational& other) noexcept {
+        return *this = *this + other;
+    }
+
+    Rational& operator-=(const Rational& other) noexcept {
+        return *this = *this - other;
+    }
+
+    Rational& operator*=(const Rational& other) noexcept {
+        return *this = *this * other;
+    }
+
+    Rational& operator/=(const Rational& other) {
+        return *this = *this / other;
+    }
+
+    friend Rational abs(const Rational& num) noexcept;
+
+    friend std::string to_string(const Rational& num) noexcept;
+
+    friend Rational pow(const Rational& num, const Large& n);
+
+    friend std::istream& operator>>(std::istream& is, Rational& num);
+
+    friend std::ostream& operator<<(std::ostream& os, const Rational& num) noexcept;
+
+private:
+    mutable Large numerator_, denominator_;
+    mutable bool normalized_ = true;
+
+    static const size_t max_lazy_size_ = 16;
+
+    [[nodiscard]] bool IsSmall() const noexcept {
+        return numerator_.Size() == 1 && denominator_.Size() == 1;
+    }
+
+    static Rational FromSmall(int64_t numerator, int64_t denominator) noexcept;
+
+    static Rational FromLarge(Large numerator, Large denominator) noexcept;
+};
@@ -1,54 +1,201 @@
 #include <iostream>
+#include <string>
+#include <cctype>
+#include <cstring>
+#include <map>
+#include <queue>
+#include <mutex>
+#include <thread>
+#include <optional>
+#include <semaphore>
+#include <condition_variable>
 #include "LinearEquationSystem.h"
 
-int main() {
+template<class T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity) {}
+
+    void Push(T value) {
+        std::unique_lock lock(mutex_);
+        not_full_.wait(lock, [&]() {
+            return queue_.size() < capacity_;
+        });
+        queue_.push(std::move(value));
+        not_empty_.notify_one();
+    }
+
+    std::optional<T> Pop() {
+        std::unique_lock lock(mutex_);
+        not_empty_.wait(lock, [&]() {
+            return !queue_.empty() || closed_;
+        });
+        if (queue_.empty()) {
+            return std::nullopt;
+        }
+        T value = std::move(queue_.front());
+        queue_.pop();
+        not_full_.notify_one();
+        return value;
+    }
+
+    void Close() {
+        std::lock_guard lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+    }
+
+private:
+    size_t capacity_;
+    bool closed_ = false;
+    std::queue<T> queue_;
+    std::mutex mutex_;
+    std::condition_variable not_full_, not_empty_;
+};
+
+struct SolveTask {
+    size_t index;
+    Matrix<Large> ratio, rcol;
+};
+
+struct SolveResult {
+    size_t index;
+    LinearEquationSystem system;
+};
+
+bool ReadSystem(std::istream& in, Matrix<Large>& A, Matrix<Large>& B) {
     int N;
-    std::cin >> N;
-    Matrix<Large> A(N, N), B(N, 1);
+    if (!(in >> N) || N < 0) {
+        return false;
+    }
+    A = Matrix<Large>(N, N), B = Matrix<Large>(N, 1);
     for(int i = 0; i < N; ++i) {
         for(int j = 0; j < N; ++j) {
-            std::cin >> A(i, j);
+            in >> A(i, j);
         }
-        std::cin >> B(i, 0);
+        in >> B(i, 0);
     }
-    LinearEquationSystem sys = {A, B};
-    sys.Solve();
-    std::cout << sys << std::endl << std::endl;
+    return static_cast<bool>(in);
+}
+
+bool PrintSystem(std::ostream& out, const LinearEquationSystem& sys) {
+    out << sys << std::endl << std::endl;
 
     auto solutions = sys.GetSolutions();
     if (solutions.empty()) {
-        std::cout << "No solutions";
-        return 0;
+        out << "No solutions";
+        return false;
     }
     for (const auto &solution: solutions) {
         if (solution.variable.coeff == -1) {
-            std::cout << "-";
+            out << "-";
         } else if (solution.variable.coeff != 1) {
-            std::cout << solution.variable.coeff << "*";
+            out << solution.variable.coeff << "*";
         }
-        std::cout << "x_" << solution.variable.var_index << " = ";
+        out << "x_" << solution.variable.var_index << " = ";
 
         bool is_first = true;
         for (const auto &var: solution.expression) {
             if (is_first && var.coeff < 0) {
-                std::cout << "-";
+                out << "-";
             } else if (!is_first && var.coeff < 0) {
-                std::cout << " - ";
+                out << " - ";
             } else if (!is_first && var.coeff > 0) {
-                std::cout << " + ";
+                out << " + ";
             }
 
             if (var.var_index == 0) {
-                std::cout << abs(var.coeff);
+                out << abs(var.coeff);
                 continue;
             }
 
             if (abs(var.coeff) != 1) {
-                std::cout << abs(var.coeff) << "*";
+                out << abs(var.coeff) << "*";
             }
-            std::cout << "x_" << var.var_index;
+            out << "x_" << var.var_index;
             is_first = false;
         }
-        std::cout << std::endl;
+        out << std::endl;
+    }
+    return true;
+}
+
+bool ParseThreads(const char* arg, size_t& threads) {
+    const std::string value = arg;
+    if (value.empty() || !std::isdigit(static_cast<unsigned char>(value[0]))) {
+        return false;
+    }
+    try {
+        size_t length = 0;
+        threads = std::stoul(value, &length);
+        return length == value.size() && threads > 0;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+void SolveBatch(size_t threads) {
+    const size_t in_flight = 4 * threads;
+    std::counting_semaphore<> slots(static_cast<std::ptrdiff_t>(in_flight));
+    BoundedQueue<SolveTask> tasks(2 * threads);
+    BoundedQueue<SolveResult> results(2 * threads);
+
+    std::vector<std::thread> workers;
+    for(size_t i = 0; i < threads; ++i) {
+        workers.emplace_back([&]() {
+            while (std::optional<SolveTask> task = tasks.Pop()) {
+                LinearEquationSystem sys = {task->ratio, task->rcol};
+                sys.Solve();
+                results.Push({task->index, std::move(sys)});
+            }
+        });
+    }
+
+    std::thread writer([&]() {
+        std::map<size_t, LinearEquationSystem> pending;
+        size_t next = 0;
+        while (std::optional<SolveResult> result = results.Pop()) {
+            pending.emplace(result->index, std::move(result->system));
+            for(auto it = pending.begin(); it != pending.end() && it->first == next; it = pending.erase(it), ++next) {
+                if (next != 0) {
+                    std::cout << std::endl;
+                }
+                if (!PrintSystem(std::cout, it->second)) {
+                    std::cout << std::endl;
+                }
+                slots.release();
+            }
+        }
+        std::cout.flush();
+    });
+
+    Matrix<Large> A, B;
+    for(size_t index = 0; ReadSystem(std::cin, A, B); ++index) {
+        slots.acquire();
+        tasks.Push({index, std::move(A), std::move(B)});
+    }
+    tasks.Close();
+    for(std::thread& worker : workers) {
+        worker.join();
+    }
+    results.Close();
+    writer.join();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "--batch") == 0) {
+        size_t threads = std::thread::hardware_concurrency();
+        if (argc > 3 || (argc == 3 && !ParseThreads(argv[2], threads))) {
+            std::cerr << "Usage: " << argv[0] << " [--batch [threads]]" << std::endl;
+            return 1;
+        }
+        SolveBatch(std::max<size_t>(threads, 1));
+        return 0;
     }
+
+    Matrix<Large> A, B;
+    ReadSystem(std::cin, A, B);
+    LinearEquationSystem sys = {A, B};
+    sys.Solve();
+    PrintSystem(std::cout, sys);
 }
@@ -0,0 +1,77 @@
+#include <iostream>
+#include <random>
+#include <filesystem>
+#include "Matrix.t.h"
+#include "MappedMatrix.t.h"
+
+namespace {
+    Matrix<int64_t> RandomMatrix(std::mt19937& gen, size_t rows, size_t cols) {
+        Matrix<int64_t> result(rows, cols);
+        return result.ForEach([&](size_t, size_t, int64_t& elem) {
+            elem = static_cast<int64_t>(gen() % 201) - 100;
+        });
+    }
+
+    template<class Exception, class Func>
+    bool Throws(Func&& func) {
+        try {
+            func();
+        } catch (const Exception&) {
+            return true;
+        }
+        return false;
+    }
+}
+
+int main() {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "MappedMatrixTest";
+    std::filesystem::create_directories(dir);
+    const std::string lhs_path = dir / "lhs.bin", rhs_path = dir / "rhs.bin";
+    size_t failures = 0;
+    auto check = [&](bool condition, const char* message) {
+        if (!condition) {
+            std::cerr << message << "\n";
+            ++failures;
+        }
+    };
+
+    std::mt19937 gen(40);
+    const Matrix<int64_t> lhs = RandomMatrix(gen, 37, 23), rhs = RandomMatrix(gen, 23, 19);
+    {
+        // small panels and only two of them mapped, so every operation crosses panels and evicts
+        auto mapped_lhs = MappedMatrix<int64_t>::FromMatrix(lhs, lhs_path, 5, 2);
+        auto mapped_rhs = MappedMatrix<int64_t>::FromMatrix(rhs, rhs_path, 4, 2);
+        check(mapped_lhs.ToMatrix() == lhs, "FromMatrix() and ToMatrix() do not round-trip");
+        check(mapped_lhs(36, 22) == lhs(36, 22), "operator() reads a wrong element");
+
+        check(mapped_lhs.Transposed(dir / "transposed.bin").ToMatrix() == lhs.Transposed(), "Transposed() is wrong");
+        check(mapped_lhs.Multiply(mapped_rhs, dir / "product.bin").ToMatrix() == lhs * rhs, "Multiply() is wrong");
+
+        check(Throws<std::invalid_argument>([&]() { (void)mapped_lhs.Transposed(lhs_path); }),
+              "Transposed() overwrote its operand");
+        check(Throws<std::invalid_argument>([&]() { (void)mapped_lhs.Multiply(mapped_rhs, lhs_path); }),
+              "Multiply() overwrote its left operand");
+        check(Throws<std::invalid_argument>([&]() {
+            (void)mapped_lhs.Multiply(mapped_rhs, (dir / ".." / dir.filename() / "rhs.bin").string());
+        }), "Multiply() overwrote its right operand through another path");
+        check(Throws<std::length_error>([&]() { (void)mapped_rhs.Multiply(mapped_lhs, dir / "wrong.bin"); }),
+              "Multiply() accepted incompatible sizes");
+
+        mapped_lhs.Set(0, 0, 12345);
+        mapped_lhs.Flush();
+    }
+
+    Matrix<int64_t> expected = lhs;
+    expected(0, 0) = 12345;
+    auto opened = MappedMatrix<int64_t>::Open(lhs_path, 23, 8, 2);
+    check(opened.rows() == 37 && opened.columns() == 23, "Open() inferred wrong sizes");
+    check(opened.ToMatrix() == expected, "Open() does not see the stored matrix");
+    check(MappedMatrix<int64_t>::Open(rhs_path, 19).ToMatrix() == rhs, "the overwrite guard changed an operand");
+    check(Throws<std::length_error>([&]() { (void)MappedMatrix<int64_t>::Open(lhs_path, 24); }),
+          "Open() accepted a file that does not match the row size");
+    check(Throws<std::system_error>([&]() { (void)MappedMatrix<int64_t>::Open(dir / "missing.bin", 1); }),
+          "Open() accepted a missing file");
+
+    std::filesystem::remove_all(dir);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <sstream>
+#include <random>
+#include "LinearEquationSystem.h"
+
+namespace {
+    // rows repeat up to a multiplier, columns are often empty and every other system is inconsistent
+    std::pair<Matrix<Large>, Matrix<Large>> RandomSystem(std::mt19937& gen) {
+        const size_t rows = gen() % 6 + 1, cols = gen() % 6 + 1;
+        Matrix<Large> ratio(rows, cols), rcol(rows, 1);
+        std::vector<bool> empty(cols);
+        for(size_t col = 0; col < cols; ++col) {
+            empty[col] = gen() % 3 == 0;
+        }
+        for(size_t row = 0; row < rows; ++row) {
+            if (row > 0 && gen() % 2 == 0) {
+                const size_t other = gen() % row;
+                const int64_t factor = static_cast<int64_t>(gen() % 7) - 3;
+                for(size_t col = 0; col < cols; ++col) {
+                    ratio(row, col) = ratio(other, col) * factor;
+                }
+                rcol(row, 0) = rcol(other, 0) * factor + (gen() % 4 == 0 ? 1 : 0);
+                continue;
+            }
+            for(size_t col = 0; col < cols; ++col) {
+                ratio(row, col) = empty[col] ? Large(0) : Large(static_cast<int64_t>(gen() % 11) - 5);
+            }
+            rcol(row, 0) = static_cast<int64_t>(gen() % 11) - 5;
+        }
+        return { ratio, rcol };
+    }
+
+    std::string ToString(const std::vector<LinearSolution>& solutions) {
+        std::ostringstream out;
+        for(const LinearSolution& solution : solutions) {
+            out << solution.variable.coeff << "*x_" << solution.variable.var_index << " =";
+            for(const ExpressionPart& part : solution.expression) {
+                out << ' ' << part.coeff << "*x_" << part.var_index;
+            }
+            out << "; ";
+        }
+        return out.str();
+    }
+
+    template<class T>
+    std::string ToString(const T& value) {
+        std::ostringstream out;
+        out << value;
+        return out.str();
+    }
+}
+
+int main() {
+    std::mt19937 gen(39);
+    size_t failures = 0, rejected = 0;
+    auto check = [&](bool condition, size_t test, const char* message) {
+        if (!condition) {
+            std::cerr << "system " << test << ": " << message << "\n";
+            ++failures;
+        }
+    };
+    for(size_t test = 0; test < 500; ++test) {
+        auto [ratio, rcol] = RandomSystem(gen);
+        LinearEquationSystem system = {ratio, rcol}, blocked = {ratio, rcol};
+        system.Solve();
+        blocked.SolveBlocked();
+
+        check(system.IsConsistent() == blocked.IsConsistent(), test, "consistency differs from SolveBlocked()");
+        check(system.Rank() == blocked.Rank(), test, "rank differs from SolveBlocked()");
+        if (blocked.IsConsistent()) {
+            check(ToString(system) == ToString(blocked), test, "reduced form differs from SolveBlocked()");
+        } else {
+            check(system.GetSolutions().empty(), test, "an inconsistent system has solutions");
+        }
+
+        // any right-hand side in the column space of the ratio matrix must be solvable through SolveFor
+        Matrix<Large> other(ratio.rows(), 1);
+        for(size_t row = 0; row < ratio.rows(); ++row) {
+            for(size_t col = 0; col < ratio.columns(); ++col) {
+                other(row, 0) += ratio(row, col) * static_cast<int64_t>(col % 3 + 1);
+            }
+        }
+        LinearEquationSystem expected = {ratio, other};
+        expected.Solve();
+        check(ToString(system.SolveFor(other)[0]) == ToString(expected.GetSolutions()), test,
+              "SolveFor() differs from a fresh Solve()");
+        rejected += !system.IsConsistent();
+    }
+    if (rejected == 0) {
+        std::cerr << "no inconsistent systems were generated\n";
+        ++failures;
+    }
+    return failures == 0 ? 0 : 1;
+}
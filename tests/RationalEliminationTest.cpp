@@ -0,0 +1,86 @@
+#include <iostream>
+#include <sstream>
+#include <random>
+#include "Rational.h"
+#include "LinearEquationSystem.h"
+
+template<class T>
+concept Invertible = requires(const Matrix<T>& matrix) { matrix.Inverse(); };
+
+// integer division would make Matrix<Large>::Inverse() silently wrong
+static_assert(!Invertible<Large> && !Invertible<int64_t>);
+static_assert(Invertible<Rational> && Invertible<double>);
+
+namespace {
+    template<class T>
+    std::string ToString(const T& value) {
+        std::ostringstream out;
+        out << value;
+        return out.str();
+    }
+}
+
+int main() {
+    std::mt19937 gen(28);
+    size_t failures = 0, singular = 0;
+    auto check = [&](bool condition, size_t test, const char* message) {
+        if (!condition) {
+            std::cerr << "test " << test << ": " << message << "\n";
+            ++failures;
+        }
+    };
+
+    for(size_t test = 0; test < 300; ++test) {
+        const size_t n = gen() % 5 + 1;
+        Matrix<Rational> matrix(n, n), identity(n, n);
+        matrix.ForEach([&](size_t, size_t, Rational& elem) {
+            elem = gen() % 3 == 0 ? Rational(0) : Rational(static_cast<int64_t>(gen() % 9) - 4,
+                                                             static_cast<int64_t>(gen() % 3) + 1);
+        });
+        identity.ForEach([&](size_t i, size_t j, Rational& elem) {
+            elem = i == j ? 1 : 0;
+        });
+        std::optional<Matrix<Rational>> inverse = matrix.Inverse();
+        if (!inverse) {
+            Matrix<Rational> reduced = matrix;
+            check(reduced.RowReduce(n).size() < n, test, "Inverse() rejected a nonsingular matrix");
+            ++singular;
+            continue;
+        }
+        check(matrix * *inverse == identity && *inverse * matrix == identity, test, "Inverse() is wrong");
+    }
+    check(singular > 0, 0, "no singular matrices were generated");
+    check(!Matrix<Rational>(2, 3).Inverse(), 0, "a non-square matrix was inverted");
+    check(!Matrix<double>({{1, 2}, {2, 4}}).Inverse(), 0, "a singular Matrix<double> was inverted");
+    const std::optional<Matrix<double>> inverse = Matrix<double>({{4, 7}, {2, 6}}).Inverse();
+    check(inverse && std::abs((*inverse)(0, 0) - 0.6) < 1e-12 && std::abs((*inverse)(1, 0) + 0.2) < 1e-12, 0,
+          "Matrix<double>::Inverse() is wrong");
+
+    // SolveRational() must end in the same reduced form as Solve()
+    for(size_t test = 0; test < 300; ++test) {
+        const size_t rows = gen() % 5 + 1, cols = gen() % 5 + 1;
+        Matrix<Large> ratio(rows, cols), rcol(rows, 2);
+        ratio.ForEach([&](size_t, size_t, Large& elem) {
+            elem = gen() % 3 == 0 ? Large(0) : Large(static_cast<int64_t>(gen() % 13) - 6);
+        });
+        rcol.ForEach([&](size_t, size_t, Large& elem) {
+            elem = static_cast<int64_t>(gen() % 13) - 6;
+        });
+        if (rows > 1 && gen() % 2 == 0) {
+            ratio.ForRow(rows - 1, [&](size_t col, Large& elem) {
+                elem = ratio(0, col) * 2;
+            });
+            rcol(rows - 1, 0) = rcol(0, 0) * 2;
+            rcol(rows - 1, 1) = rcol(0, 1) * 2;
+        }
+        LinearEquationSystem exact = {ratio, rcol}, rational = {ratio, rcol};
+        exact.Solve();
+        rational.SolveRational();
+        check(exact.IsConsistent() == rational.IsConsistent(), test, "SolveRational() differs in consistency");
+        check(exact.Rank() == rational.Rank(), test, "SolveRational() differs in rank");
+        if (exact.IsConsistent()) {
+            check(ToString(exact) == ToString(rational), test, "SolveRational() differs from Solve()");
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+#include <iostream>
+#include <sstream>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include "LinearEquationSystem.h"
+
+namespace {
+    using PivotStrategy = LinearEquationSystem::PivotStrategy;
+
+    // a consistent rank-deficient system, so that pivot columns depend on the strategy
+    std::pair<Matrix<Large>, Matrix<Large>> RandomSystem(std::mt19937& gen) {
+        const size_t rows = gen() % 5 + 2, cols = gen() % 5 + 2;
+        Matrix<Large> ratio(rows, cols), rcol(rows, 1);
+        std::vector<int64_t> solution(cols);
+        for(int64_t& value : solution) {
+            value = static_cast<int64_t>(gen() % 7) - 3;
+        }
+        for(size_t row = 0; row < rows; ++row) {
+            if (row > 0 && gen() % 3 == 0) {
+                const size_t other = gen() % row;
+                const int64_t factor = static_cast<int64_t>(gen() % 5) - 2;
+                for(size_t col = 0; col < cols; ++col) {
+                    ratio(row, col) = ratio(other, col) * factor;
+                }
+            } else {
+                for(size_t col = 0; col < cols; ++col) {
+                    ratio(row, col) = gen() % 2 == 0 ? Large(0) : Large(static_cast<int64_t>(gen() % 19) - 9);
+                }
+            }
+            for(size_t col = 0; col < cols; ++col) {
+                rcol(row, 0) += ratio(row, col) * solution[col];
+            }
+        }
+        return { ratio, rcol };
+    }
+
+    std::string Solved(const Matrix<Large>& ratio, const Matrix<Large>& rcol, PivotStrategy strategy) {
+        LinearEquationSystem system = {ratio, rcol};
+        system.Solve(strategy);
+        std::ostringstream out;
+        out << system;
+        return out.str();
+    }
+}
+
+int main() {
+    const char* names[] = { "First", "SmallestSize", "Markowitz", "Full" };
+    size_t failures = 0;
+    for(PivotStrategy strategy : { PivotStrategy::First, PivotStrategy::SmallestSize, PivotStrategy::Markowitz,
+                                   PivotStrategy::Full }) {
+        std::mt19937 gen(2024);
+        size_t hits = 0;
+        for(size_t test = 0; test < 200; ++test) {
+            auto [ratio, rcol] = RandomSystem(gen);
+            std::vector<size_t> order(ratio.rows());
+            std::iota(order.begin(), order.end(), 0);
+            std::shuffle(order.begin(), order.end(), gen);
+            Matrix<Large> permuted_ratio(ratio.rows(), ratio.columns()), permuted_rcol(rcol.rows(), 1);
+            for(size_t row = 0; row < order.size(); ++row) {
+                for(size_t col = 0; col < ratio.columns(); ++col) {
+                    permuted_ratio(row, col) = ratio(order[row], col);
+                }
+                permuted_rcol(row, 0) = rcol(order[row], 0);
+            }
+
+            LinearEquationSystem::EnableCache(0);
+            const std::string expected = Solved(permuted_ratio, permuted_rcol, strategy);
+            LinearEquationSystem::EnableCache(16);
+            Solved(ratio, rcol, strategy);
+            const std::string cached = Solved(permuted_ratio, permuted_rcol, strategy);
+            hits += LinearEquationSystem::GetCacheStats().hits;
+            if (cached != expected) {
+                std::cerr << names[static_cast<size_t>(strategy)] << ", system " << test
+                          << ": cached result differs from a fresh Solve\n" << cached << "\n\n" << expected << "\n";
+                ++failures;
+            }
+        }
+        // row order is normalized in the key only where it cannot change the result
+        const bool sorted = strategy == PivotStrategy::First || strategy == PivotStrategy::SmallestSize;
+        if (sorted && hits == 0) {
+            std::cerr << names[static_cast<size_t>(strategy)] << ": permuted systems never hit the cache\n";
+            ++failures;
+        }
+    }
+    LinearEquationSystem::EnableCache(0);
+    return failures == 0 ? 0 : 1;
+}